@@ -0,0 +1,91 @@
+// AtomicBitmap throughput benchmark
+// Each thread repeatedly claims a frame and releases it, scaling the
+// thread count from 1 up to twice the number of online CPUs.
+// Build and run with: make bench_atomic_bitmap && ./bench_atomic_bitmap
+
+#define _POSIX_C_SOURCE 200809L
+#include "ds_header.h"
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_BITS (1 << 20)        // 1M frames
+#define BENCH_PREFILL 0.90          // fraction of frames already in use
+#define BENCH_OPS 1000000           // claim/release pairs per thread
+#define BENCH_MAX_THREADS 256
+
+static AtomicBitmap bitmap;
+
+//------------------------------------------------------------------//
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+//------------------------------------------------------------------//
+
+static void *bench_worker(void *arg)
+{
+    (void)arg;
+    for (int i = 0; i < BENCH_OPS; i++)
+    {
+        int n = abitmap_claim_bit(&bitmap);
+        if (n >= 0)
+        {
+            abitmap_clear_bit(&bitmap, n);
+        }
+    }
+    return NULL;
+}
+
+//------------------------------------------------------------------//
+
+int main(void)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int max_threads = cpus > 0 ? (int)cpus * 2 : 2;
+    if (max_threads > BENCH_MAX_THREADS)
+    {
+        max_threads = BENCH_MAX_THREADS;
+    }
+
+    if (abitmap_init(&bitmap, BENCH_BITS) != 0)
+    {
+        printf("Error - could not allocate bitmap\n");
+        return 1;
+    }
+    // leave free frames scattered so claims have to scan
+    for (int i = 0; i < BENCH_BITS; i++)
+    {
+        if ((double)(i % 100) < BENCH_PREFILL * 100)
+        {
+            abitmap_set_bit(&bitmap, i);
+        }
+    }
+
+    printf("%-8s %12s %14s %14s\n", "threads", "time (ms)", "Mops/s", "Mops/s/thread");
+    pthread_t threads[BENCH_MAX_THREADS];
+    for (int nthreads = 1; nthreads <= max_threads; nthreads *= 2)
+    {
+        double t0 = now_sec();
+        for (int t = 0; t < nthreads; t++)
+        {
+            pthread_create(&threads[t], NULL, bench_worker, NULL);
+        }
+        for (int t = 0; t < nthreads; t++)
+        {
+            pthread_join(threads[t], NULL);
+        }
+        double sec = now_sec() - t0;
+
+        // each op is one claim plus one release
+        double mops = (double)nthreads * BENCH_OPS * 2 / sec / 1e6;
+        printf("%-8d %12.2f %14.2f %14.2f\n", nthreads, sec * 1e3, mops, mops / nthreads);
+    }
+
+    abitmap_free(&bitmap);
+    return 0;
+}
@@ -0,0 +1,207 @@
+// Bitmap range microbenchmark
+// Compares the per-bit API (set_bit/clear_bit/test_bit loops) against the
+// bulk range operations with the scalar, SSE2 and AVX2 kernels.
+// Build and run with: make bench_bitmap && ./bench_bitmap
+
+#define _POSIX_C_SOURCE 200809L
+#include "ds_header.h"
+#include <time.h>
+
+#define BENCH_BITS (1 << 24)   // 16M frames = 64 GiB of 4 KiB pages
+#define BENCH_RUN 512          // contiguous frames requested by the run finder
+#define BENCH_REPEAT 5         // best-of repetitions per measurement
+
+static volatile long long sink; // keeps results alive under -O2
+
+//------------------------------------------------------------------//
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * naive_zero_run - Per-bit run finder, the way callers do it today
+ */
+static int naive_zero_run(Bitmap *bm, int count)
+{
+    int run = 0;
+    for (int i = 0; i < bm->nbits; i++)
+    {
+        run = bitmap_test_bit(bm, i) == 0 ? run + 1 : 0;
+        if (run == count)
+        {
+            return i - count + 1;
+        }
+    }
+    return -1;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * naive_count - Per-bit population count
+ */
+static int naive_count(Bitmap *bm)
+{
+    int count = 0;
+    for (int i = 0; i < bm->nbits; i++)
+    {
+        count += bitmap_test_bit(bm, i);
+    }
+    return count;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * fragment - Build a nearly full bitmap whose only large hole is near the end
+ */
+static void fragment(Bitmap *bm)
+{
+    bitmap_set_range(bm, 0, bm->nbits);
+    // small holes everywhere so the scan cannot skip trivially
+    for (int i = 1000; i < bm->nbits; i += 4099)
+    {
+        bitmap_clear_range(bm, i, i + 7);
+    }
+    bitmap_clear_range(bm, bm->nbits - 2 * BENCH_RUN, bm->nbits - BENCH_RUN);
+}
+
+//------------------------------------------------------------------//
+
+static void report(const char *op, const char *impl, double sec)
+{
+    printf("%-12s %-10s %10.3f ms %10.2f Gbit/s\n", op, impl, sec * 1e3, (double)BENCH_BITS / sec / 1e9);
+}
+
+//------------------------------------------------------------------//
+
+int main(void)
+{
+    static const char *level_names[] = {"scalar", "sse2", "avx2"};
+    Bitmap *bm = bitmap_create(BENCH_BITS);
+    if (bm == NULL)
+    {
+        printf("Error allocating %d-bit bitmap\n", BENCH_BITS);
+        return 1;
+    }
+
+    printf("%-12s %-10s %13s %17s\n", "operation", "impl", "time", "throughput");
+
+    // set / clear the whole range: per-bit loop vs bulk fill
+    double best_bit = 1e9, best_range = 1e9;
+    for (int r = 0; r < BENCH_REPEAT; r++)
+    {
+        double t0 = now_sec();
+        for (int i = 0; i < BENCH_BITS; i++)
+        {
+            bitmap_set_bit(bm, i);
+        }
+        double t1 = now_sec();
+        bitmap_clear_range(bm, 0, BENCH_BITS);
+        double t2 = now_sec();
+        bitmap_set_range(bm, 0, BENCH_BITS);
+        double t3 = now_sec();
+        best_bit = t1 - t0 < best_bit ? t1 - t0 : best_bit;
+        best_range = t3 - t2 < best_range ? t3 - t2 : best_range;
+    }
+    report("set", "per-bit", best_bit);
+    report("set", "range", best_range);
+
+    best_bit = 1e9;
+    best_range = 1e9;
+    for (int r = 0; r < BENCH_REPEAT; r++)
+    {
+        double t0 = now_sec();
+        for (int i = 0; i < BENCH_BITS; i++)
+        {
+            bitmap_clear_bit(bm, i);
+        }
+        double t1 = now_sec();
+        bitmap_set_range(bm, 0, BENCH_BITS);
+        double t2 = now_sec();
+        bitmap_clear_range(bm, 0, BENCH_BITS);
+        double t3 = now_sec();
+        best_bit = t1 - t0 < best_bit ? t1 - t0 : best_bit;
+        best_range = t3 - t2 < best_range ? t3 - t2 : best_range;
+    }
+    report("clear", "per-bit", best_bit);
+    report("clear", "range", best_range);
+
+    // popcount and run finder on a fragmented, nearly full bitmap
+    fragment(bm);
+    int expected_count = naive_count(bm);
+    int expected_run = naive_zero_run(bm, BENCH_RUN);
+
+    best_bit = 1e9;
+    for (int r = 0; r < BENCH_REPEAT; r++)
+    {
+        double t0 = now_sec();
+        sink += naive_count(bm);
+        double t1 = now_sec();
+        best_bit = t1 - t0 < best_bit ? t1 - t0 : best_bit;
+    }
+    report("popcount", "per-bit", best_bit);
+
+    for (int level = BITMAP_SIMD_SCALAR; level <= BITMAP_SIMD_AVX2; level++)
+    {
+        if (bitmap_simd_select(level) != level)
+        {
+            continue;
+        }
+        double best = 1e9;
+        for (int r = 0; r < BENCH_REPEAT; r++)
+        {
+            double t0 = now_sec();
+            int count = bitmap_count_range(bm, 0, BENCH_BITS);
+            double t1 = now_sec();
+            if (count != expected_count)
+            {
+                printf("Error - %s popcount %d, expected %d\n", level_names[level], count, expected_count);
+                return 1;
+            }
+            best = t1 - t0 < best ? t1 - t0 : best;
+        }
+        report("popcount", level_names[level], best);
+    }
+
+    best_bit = 1e9;
+    for (int r = 0; r < BENCH_REPEAT; r++)
+    {
+        double t0 = now_sec();
+        sink += naive_zero_run(bm, BENCH_RUN);
+        double t1 = now_sec();
+        best_bit = t1 - t0 < best_bit ? t1 - t0 : best_bit;
+    }
+    report("zero_run", "per-bit", best_bit);
+
+    for (int level = BITMAP_SIMD_SCALAR; level <= BITMAP_SIMD_AVX2; level++)
+    {
+        if (bitmap_simd_select(level) != level)
+        {
+            continue;
+        }
+        double best = 1e9;
+        for (int r = 0; r < BENCH_REPEAT; r++)
+        {
+            double t0 = now_sec();
+            int run = bitmap_find_zero_run(bm, BENCH_RUN);
+            double t1 = now_sec();
+            if (run != expected_run)
+            {
+                printf("Error - %s zero run at %d, expected %d\n", level_names[level], run, expected_run);
+                return 1;
+            }
+            best = t1 - t0 < best ? t1 - t0 : best;
+        }
+        report("zero_run", level_names[level], best);
+    }
+
+    bitmap_destroy(bm);
+    return 0;
+}
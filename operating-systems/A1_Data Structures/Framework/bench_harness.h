@@ -0,0 +1,181 @@
+/**
+ * @file bench_harness.h
+ * @brief Minimal timing harness for the data structure benchmarks.
+ *
+ * A benchmark case is a function that runs its phases (e.g. fill, then
+ * drain) and brackets each one with bench_begin/bench_end. bench_case
+ * runs it once as a warm-up, then repeats it and keeps the fastest time
+ * of every phase. Wall time comes from clock_gettime, with the timer's own
+ * overhead subtracted; cycles come from rdtsc on x86 (0 elsewhere).
+ * Results are written as CSV rows. Define _POSIX_C_SOURCE before any
+ * include in the file that uses it, for clock_gettime.
+ */
+
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_RDTSC 1
+#endif
+
+#define BENCH_MAX_PHASES 8
+
+/**
+ * BenchPhase - Best result of one timed phase across repetitions.
+ * @op: Operation name, used as the CSV op column
+ * @ops: Operations performed in the phase
+ * @best_ns: Fastest wall time seen
+ * @best_cycles: TSC cycles of that fastest run
+ */
+typedef struct {
+    const char* op;
+    long ops;
+    double best_ns;
+    uint64_t best_cycles;
+} BenchPhase;
+
+/**
+ * BenchTimer - Phase results of one case plus the running measurement.
+ * @phases: Results, in the order the case records them
+ * @nphases: Number of phases recorded so far
+ * @cur: Phase index for the next bench_end in this repetition
+ * @start_ns, @start_cycles: Set by bench_begin
+ */
+typedef struct {
+    BenchPhase phases[BENCH_MAX_PHASES];
+    int nphases;
+    int cur;
+    double start_ns;
+    uint64_t start_cycles;
+} BenchTimer;
+
+typedef void (*BenchCase)(long size, BenchTimer* t);
+
+static double bench_timer_overhead_ns;
+
+//------------------------------------------------------------------//
+
+static inline double bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static inline uint64_t bench_cycles(void)
+{
+#ifdef BENCH_HAVE_RDTSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * bench_calibrate - Measure the cost of an empty begin/end pair
+ * Call once before the first case.
+ */
+static inline void bench_calibrate(void)
+{
+    double best = 1e18;
+    for (int i = 0; i < 1000; i++)
+    {
+        double t0 = bench_now_ns();
+        double t1 = bench_now_ns();
+        if (t1 - t0 < best)
+        {
+            best = t1 - t0;
+        }
+    }
+    bench_timer_overhead_ns = best;
+}
+
+//------------------------------------------------------------------//
+
+static inline void bench_begin(BenchTimer* t)
+{
+    t->start_cycles = bench_cycles();
+    t->start_ns = bench_now_ns();
+}
+
+/**
+ * bench_end - Close the current phase and keep it if it is the fastest
+ * @param t: Timer passed to the case
+ * @param op: Phase name
+ * @param ops: Operations performed since bench_begin
+ */
+static inline void bench_end(BenchTimer* t, const char* op, long ops)
+{
+    double ns = bench_now_ns() - t->start_ns - bench_timer_overhead_ns;
+    uint64_t cycles = bench_cycles() - t->start_cycles;
+    if (ns < 0)
+    {
+        ns = 0;
+    }
+    if (t->cur >= BENCH_MAX_PHASES)
+    {
+        return;
+    }
+
+    BenchPhase* phase = &t->phases[t->cur++];
+    if (t->cur > t->nphases)
+    {
+        t->nphases = t->cur;
+        phase->op = op;
+        phase->ops = ops;
+        phase->best_ns = ns;
+        phase->best_cycles = cycles;
+    }
+    else if (ns < phase->best_ns)
+    {
+        phase->best_ns = ns;
+        phase->best_cycles = cycles;
+    }
+}
+
+//------------------------------------------------------------------//
+
+static inline void bench_csv_header(FILE* out)
+{
+    fprintf(out, "structure,variant,op,size,ops,ns_per_op,cycles_per_op\n");
+}
+
+/**
+ * bench_case - Warm up, repeat a case and print one CSV row per phase
+ * @param out: CSV destination
+ * @param structure, variant: Labels for the CSV row
+ * @param fn: Case to run
+ * @param size: Problem size passed to the case
+ * @param reps: Measured repetitions after the warm-up (at least 1)
+ */
+static inline void bench_case(FILE* out, const char* structure, const char* variant, BenchCase fn, long size,
+                              int reps)
+{
+    BenchTimer t;
+    t.nphases = 0;
+    t.cur = 0;
+    fn(size, &t);
+
+    // the warm-up run only sets the phase names; start the minimums over
+    t.nphases = 0;
+    for (int r = 0; r < (reps > 0 ? reps : 1); r++)
+    {
+        t.cur = 0;
+        fn(size, &t);
+    }
+
+    for (int i = 0; i < t.nphases; i++)
+    {
+        BenchPhase* p = &t.phases[i];
+        long ops = p->ops > 0 ? p->ops : 1;
+        fprintf(out, "%s,%s,%s,%ld,%ld,%.3f,%.2f\n", structure, variant, p->op, size, p->ops,
+                p->best_ns / (double)ops, (double)p->best_cycles / (double)ops);
+    }
+    fflush(out);
+}
+
+#endif // BENCH_HARNESS_H
@@ -0,0 +1,225 @@
+// Priority queue benchmark
+// Replays scheduler-style and Dijkstra-style operation traces against
+// the binary MinHeap, the 4-ary heap and the pairing heap through the
+// PriorityQueue interface. Every backend sees the same inserts, and the
+// sum of extracted priorities is checked to match across backends.
+// Build and run with: make bench_heaps && ./bench_heaps
+
+#define _POSIX_C_SOURCE 200809L
+#include "ds_header.h"
+#include <time.h>
+
+#define BENCH_OPS 2000000       // mixed operations after the initial fill
+#define OP_INSERT 0
+#define OP_EXTRACT 1
+
+typedef struct {
+    int op;
+    HeapNode node;
+} TraceOp;
+
+typedef struct {
+    TraceOp *ops;
+    long count;
+} Trace;
+
+//------------------------------------------------------------------//
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void trace_push(Trace *trace, int op, int value, int priority)
+{
+    trace->ops[trace->count].op = op;
+    trace->ops[trace->count].node.value = value;
+    trace->ops[trace->count].node.priority = priority;
+    trace->count++;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * build_scheduler_trace - CFS-like run queue of `tasks` runnable tasks
+ *
+ * Each step picks the task with the smallest virtual runtime, runs it
+ * for a random slice and puts it back with the larger runtime. Now and
+ * then a task exits or a new one arrives at the current minimum.
+ * A reference DaryHeap drives the simulation so the trace is fixed.
+ */
+static void build_scheduler_trace(Trace *trace, int tasks)
+{
+    DaryHeap ref;
+    dheap_init(&ref, tasks + 1);
+    int next_pid = 0;
+
+    for (; next_pid < tasks; next_pid++)
+    {
+        HeapNode task = {next_pid, rand() % 1000};
+        trace_push(trace, OP_INSERT, task.value, task.priority);
+        dheap_insert(&ref, task);
+    }
+
+    while (trace->count < tasks + BENCH_OPS)
+    {
+        HeapNode task = dheap_extract_min(&ref);
+        trace_push(trace, OP_EXTRACT, 0, 0);
+
+        int roll = rand() % 100;
+        if (roll < 2 && ref.size > tasks / 2)
+        {
+            continue; // task exits
+        }
+        if (roll < 4 && ref.size < tasks - 1)
+        {
+            HeapNode fresh = {next_pid++, task.priority};
+            trace_push(trace, OP_INSERT, fresh.value, fresh.priority);
+            dheap_insert(&ref, fresh);
+        }
+        task.priority += 1 + rand() % 10;
+        trace_push(trace, OP_INSERT, task.value, task.priority);
+        dheap_insert(&ref, task);
+    }
+    dheap_free(&ref);
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * build_dijkstra_trace - Lazy-deletion Dijkstra frontier of about `frontier` nodes
+ *
+ * Each step settles the closest node and relaxes 0..2 edges, pushing
+ * neighbours at the settled distance plus an edge weight. Distances only
+ * grow, like a real shortest-path search.
+ */
+static void build_dijkstra_trace(Trace *trace, int frontier)
+{
+    DaryHeap ref;
+    dheap_init(&ref, frontier + 2);
+    int next_node = 0;
+
+    for (; next_node < frontier; next_node++)
+    {
+        HeapNode node = {next_node, rand() % 100};
+        trace_push(trace, OP_INSERT, node.value, node.priority);
+        dheap_insert(&ref, node);
+    }
+
+    while (trace->count < frontier + BENCH_OPS)
+    {
+        HeapNode settled = dheap_extract_min(&ref);
+        trace_push(trace, OP_EXTRACT, 0, 0);
+
+        // keep the frontier between 3/4 and all of its target size
+        int relax = rand() % 3;
+        if (ref.size < frontier - frontier / 4)
+        {
+            relax = 2;
+        }
+        while (relax-- > 0 && ref.size < frontier)
+        {
+            HeapNode neighbour = {next_node++, settled.priority + 1 + rand() % 100};
+            trace_push(trace, OP_INSERT, neighbour.value, neighbour.priority);
+            dheap_insert(&ref, neighbour);
+        }
+    }
+    dheap_free(&ref);
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * replay - Run a trace against one backend
+ * @param checksum: Receives the sum of extracted priorities
+ * @return: Seconds taken, or -1 if an insert failed
+ */
+static double replay(Trace *trace, int kind, long long *checksum)
+{
+    PriorityQueue pq;
+    pq_init(&pq, kind);
+    long long sum = 0;
+
+    double t0 = now_sec();
+    for (long i = 0; i < trace->count; i++)
+    {
+        if (trace->ops[i].op == OP_INSERT)
+        {
+            if (pq_insert(&pq, trace->ops[i].node) != 0)
+            {
+                pq_free(&pq);
+                return -1;
+            }
+        }
+        else
+        {
+            sum += pq_extract_min(&pq).priority;
+        }
+    }
+    double sec = now_sec() - t0;
+
+    pq_free(&pq);
+    *checksum = sum;
+    return sec;
+}
+
+//------------------------------------------------------------------//
+
+int main(void)
+{
+    static const int sizes[] = {64, MAX_SIZE - 4, 10000, 1000000};
+    static const char *mixes[] = {"scheduler", "dijkstra"};
+    Trace trace;
+    trace.ops = (TraceOp *)malloc((size_t)(1000000 + 2 * BENCH_OPS) * sizeof(TraceOp));
+    if (trace.ops == NULL)
+    {
+        printf("Error - could not allocate trace\n");
+        return 1;
+    }
+
+    printf("%-10s %9s %-8s %10s %10s\n", "mix", "size", "heap", "time (ms)", "ns/op");
+    for (int mix = 0; mix < 2; mix++)
+    {
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+        {
+            srand(42);
+            trace.count = 0;
+            if (mix == 0)
+            {
+                build_scheduler_trace(&trace, sizes[s]);
+            }
+            else
+            {
+                build_dijkstra_trace(&trace, sizes[s]);
+            }
+
+            long long reference = 0;
+            for (int kind = PQ_BINARY; kind <= PQ_PAIRING; kind++)
+            {
+                long long checksum = 0;
+                double sec = replay(&trace, kind, &checksum);
+                if (sec < 0)
+                {
+                    printf("%-10s %9d %-8s %10s %10s\n", mixes[mix], sizes[s], pq_name(kind), "n/a", "(full)");
+                    continue;
+                }
+                if (reference == 0)
+                {
+                    reference = checksum;
+                }
+                else if (checksum != reference)
+                {
+                    printf("Error - %s extracted a different priority sequence\n", pq_name(kind));
+                    return 1;
+                }
+                printf("%-10s %9d %-8s %10.2f %10.1f\n", mixes[mix], sizes[s], pq_name(kind), sec * 1e3,
+                       sec * 1e9 / (double)trace.count);
+            }
+        }
+    }
+
+    free(trace.ops);
+    return 0;
+}
@@ -0,0 +1,150 @@
+// Circular list benchmark
+// Compares the head-only ring functions (insert_node/search_node/
+// delete_node walk the ring) with CircularList, plain (tail pointer only)
+// and indexed (tail pointer plus hashed key index), at 10^5 and 10^6 nodes.
+// Walking operations are timed on a sample and reported per operation,
+// with the projected time to build the whole list by repeated inserts.
+// Build and run with: make bench_list && ./bench_list
+
+#define _POSIX_C_SOURCE 200809L
+#include "ds_header.h"
+#include <time.h>
+
+#define BENCH_WALK_BUDGET 100000000L    // node visits allowed per walking sample
+#define BENCH_FAST_OPS 1000000          // operations per O(1) sample
+
+static volatile long sink;              // keeps search results alive
+
+//------------------------------------------------------------------//
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void report(int n, const char *list, const char *op, double sec, long ops)
+{
+    double ns = sec * 1e9 / (double)ops;
+    printf("%9d %-8s %-8s %12.1f", n, list, op, ns);
+    if (op[0] == 'i')
+    {
+        // building n nodes one insert at a time; a walk grows linearly,
+        // so the average insert costs about half the sampled one
+        double build = list[0] == 'w' ? ns * (double)n / 2 : ns * (double)n;
+        printf(" %14.1f", build / 1e6);
+    }
+    printf("\n");
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * bench_walk - Time the original head-only functions on an n-node ring
+ *
+ * The ring is linked by hand so setup does not take O(n^2); the samples
+ * then insert, search and delete at that size.
+ */
+static void bench_walk(int n)
+{
+    Node *head = create_node(0);
+    Node *tail = head;
+    for (int i = 1; i < n; i++)
+    {
+        tail->next = create_node(i);
+        tail = tail->next;
+    }
+    tail->next = head;
+
+    long ops = BENCH_WALK_BUDGET / n;
+    double t0 = now_sec();
+    for (long i = 0; i < ops; i++)
+    {
+        head = insert_node(head, create_node(n + (int)i));
+    }
+    report(n, "walk", "insert", now_sec() - t0, ops);
+
+    t0 = now_sec();
+    for (long i = 0; i < ops; i++)
+    {
+        sink += (long)search_node(head, rand() % n) != 0;
+    }
+    report(n, "walk", "search", now_sec() - t0, ops);
+
+    t0 = now_sec();
+    for (long i = 0; i < ops; i++)
+    {
+        head = delete_node(head, n + (int)i);
+    }
+    report(n, "walk", "delete", now_sec() - t0, ops);
+
+    free_list(head);
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * bench_list - Time CircularList append, search and delete at n nodes
+ */
+static void bench_list(int n, int indexed)
+{
+    const char *name = indexed ? "indexed" : "tail";
+    CircularList list;
+    if (list_init(&list, indexed) != 0)
+    {
+        printf("Error - could not allocate list\n");
+        return;
+    }
+
+    double t0 = now_sec();
+    for (int i = 0; i < n; i++)
+    {
+        list_append(&list, i);
+    }
+    report(n, name, "insert", now_sec() - t0, n);
+
+    // without the index every search and delete still walks
+    long ops = indexed ? BENCH_FAST_OPS : BENCH_WALK_BUDGET / n;
+    t0 = now_sec();
+    for (long i = 0; i < ops; i++)
+    {
+        sink += (long)list_search(&list, rand() % n) != 0;
+    }
+    report(n, name, "search", now_sec() - t0, ops);
+
+    // delete keys spread over the ring, then put them back at the tail
+    t0 = now_sec();
+    for (long i = 0; i < ops; i++)
+    {
+        int key = (int)((i * 7919) % n);
+        if (list_delete(&list, key) == 0)
+        {
+            list_append(&list, key);
+        }
+    }
+    report(n, name, "delete", now_sec() - t0, ops);
+
+    if (list_size(&list) != n)
+    {
+        printf("Error - %s list has %d nodes, expected %d\n", name, list_size(&list), n);
+    }
+    list_free(&list);
+}
+
+//------------------------------------------------------------------//
+
+int main(void)
+{
+    static const int sizes[] = {100000, 1000000};
+
+    srand(42);
+    printf("%9s %-8s %-8s %12s %14s\n", "nodes", "list", "op", "ns/op", "build n (ms)");
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        bench_walk(sizes[s]);
+        bench_list(sizes[s], 0);
+        bench_list(sizes[s], 1);
+    }
+    return 0;
+}
@@ -0,0 +1,236 @@
+// Concurrent queue benchmark
+// Compares a mutex-guarded CircularQueue, the SPSC ring (1 producer,
+// 1 consumer) and the MPMC queue as producer/consumer pairs grow.
+// Reports throughput and p50/p99 latency of successful enqueue/dequeue
+// calls, including the time spent retrying while full or empty.
+// Build and run with: make bench_queues && ./bench_queues
+
+#define _POSIX_C_SOURCE 200809L
+#include "ds_header.h"
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_ITEMS 1000000     // items moved per producer
+#define BENCH_CAPACITY 1024     // ring capacity (CircularQueue is fixed at MAX_SIZE)
+#define BENCH_SAMPLE_EVERY 16   // latency sampled on every Nth operation
+#define BENCH_MAX_PAIRS 32
+
+typedef struct {
+    const char *name;
+    void *queue;
+    int (*enqueue)(void *queue, int element);
+    int (*dequeue)(void *queue);
+} QueueOps;
+
+typedef struct {
+    QueueOps *ops;
+    int producer;               // 1 for producers, 0 for consumers
+    long *samples;              // latency samples in ns
+    long nsamples;
+    long max_samples;
+} Worker;
+
+static _Atomic long remaining;  // items not yet dequeued
+static _Atomic long long checksum; // sum of dequeued values, checked after each run
+
+/******************************************************************
+  BASELINE - CircularQueue behind a mutex
+******************************************************************/
+
+typedef struct {
+    CircularQueue queue;
+    pthread_mutex_t lock;
+} LockedQueue;
+
+static int locked_enqueue(void *q, int element)
+{
+    LockedQueue *lq = (LockedQueue *)q;
+    pthread_mutex_lock(&lq->lock);
+    int status = enqueue(&lq->queue, element);
+    pthread_mutex_unlock(&lq->lock);
+    return status;
+}
+
+static int locked_dequeue(void *q)
+{
+    LockedQueue *lq = (LockedQueue *)q;
+    pthread_mutex_lock(&lq->lock);
+    int element = dequeue(&lq->queue);
+    pthread_mutex_unlock(&lq->lock);
+    return element;
+}
+
+static int spsc_enqueue_op(void *q, int element) { return spsc_enqueue((SpscQueue *)q, element); }
+static int spsc_dequeue_op(void *q) { return spsc_dequeue((SpscQueue *)q); }
+static int mpmc_enqueue_op(void *q, int element) { return mpmc_enqueue((MpmcQueue *)q, element); }
+static int mpmc_dequeue_op(void *q) { return mpmc_dequeue((MpmcQueue *)q); }
+
+/******************************************************************
+  HARNESS
+******************************************************************/
+
+static long now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
+
+static int compare_long(const void *a, const void *b)
+{
+    long x = *(const long *)a, y = *(const long *)b;
+    return (x > y) - (x < y);
+}
+
+//------------------------------------------------------------------//
+
+static void *bench_worker(void *arg)
+{
+    Worker *w = (Worker *)arg;
+    long op = 0;
+
+    if (w->producer)
+    {
+        for (int i = 0; i < BENCH_ITEMS; i++, op++)
+        {
+            long t0 = op % BENCH_SAMPLE_EVERY == 0 ? now_ns() : 0;
+            // values stay non-negative, -1 is the full/empty sentinel
+            while (w->ops->enqueue(w->ops->queue, i) != 0)
+            {
+                sched_yield();
+            }
+            if (t0 != 0 && w->nsamples < w->max_samples)
+            {
+                w->samples[w->nsamples++] = now_ns() - t0;
+            }
+        }
+        return NULL;
+    }
+
+    while (atomic_load_explicit(&remaining, memory_order_relaxed) > 0)
+    {
+        long t0 = op % BENCH_SAMPLE_EVERY == 0 ? now_ns() : 0;
+        int element;
+        while ((element = w->ops->dequeue(w->ops->queue)) == -1)
+        {
+            if (atomic_load_explicit(&remaining, memory_order_relaxed) <= 0)
+            {
+                return NULL;
+            }
+            sched_yield();
+        }
+        atomic_fetch_sub_explicit(&remaining, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&checksum, element, memory_order_relaxed);
+        if (t0 != 0 && w->nsamples < w->max_samples)
+        {
+            w->samples[w->nsamples++] = now_ns() - t0;
+        }
+        op++;
+    }
+    return NULL;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * run - Move BENCH_ITEMS per producer through the queue and report
+ * @param ops: Queue under test
+ * @param pairs: Number of producers (and of consumers)
+ */
+static void run(QueueOps *ops, int pairs)
+{
+    pthread_t threads[2 * BENCH_MAX_PAIRS];
+    Worker workers[2 * BENCH_MAX_PAIRS];
+    long per_thread = BENCH_ITEMS / BENCH_SAMPLE_EVERY + 1;
+
+    atomic_store(&remaining, (long)pairs * BENCH_ITEMS);
+    atomic_store(&checksum, 0);
+    long t0 = now_ns();
+    for (int t = 0; t < 2 * pairs; t++)
+    {
+        workers[t].ops = ops;
+        workers[t].producer = t < pairs;
+        workers[t].samples = (long *)malloc((size_t)per_thread * sizeof(long));
+        workers[t].nsamples = 0;
+        workers[t].max_samples = per_thread;
+        pthread_create(&threads[t], NULL, bench_worker, &workers[t]);
+    }
+    for (int t = 0; t < 2 * pairs; t++)
+    {
+        pthread_join(threads[t], NULL);
+    }
+    double sec = (double)(now_ns() - t0) / 1e9;
+
+    long long expected = (long long)pairs * BENCH_ITEMS * (BENCH_ITEMS - 1) / 2;
+    if (atomic_load(&checksum) != expected)
+    {
+        printf("Error - %s lost or duplicated elements (checksum %lld, expected %lld)\n",
+               ops->name, atomic_load(&checksum), expected);
+    }
+
+    // merge samples from both sides for the percentiles
+    long total = 0;
+    for (int t = 0; t < 2 * pairs; t++)
+    {
+        total += workers[t].nsamples;
+    }
+    long *all = (long *)malloc((size_t)(total > 0 ? total : 1) * sizeof(long));
+    long k = 0;
+    for (int t = 0; t < 2 * pairs; t++)
+    {
+        memcpy(all + k, workers[t].samples, (size_t)workers[t].nsamples * sizeof(long));
+        k += workers[t].nsamples;
+        free(workers[t].samples);
+    }
+    qsort(all, (size_t)total, sizeof(long), compare_long);
+    long p50 = total > 0 ? all[total / 2] : 0;
+    long p99 = total > 0 ? all[total * 99 / 100] : 0;
+    free(all);
+
+    // one op = one enqueue or one dequeue
+    double mops = (double)pairs * BENCH_ITEMS * 2 / sec / 1e6;
+    printf("%-10s %6d %10.2f %12.2f %10ld %10ld\n", ops->name, pairs, sec * 1e3, mops, p50, p99);
+}
+
+//------------------------------------------------------------------//
+
+int main(void)
+{
+    static LockedQueue locked;
+    static SpscQueue spsc;
+    static MpmcQueue mpmc;
+
+    init_queue(&locked.queue);
+    pthread_mutex_init(&locked.lock, NULL);
+    if (spsc_init(&spsc, BENCH_CAPACITY) != 0 || mpmc_init(&mpmc, BENCH_CAPACITY) != 0)
+    {
+        printf("Error - could not allocate queues\n");
+        return 1;
+    }
+
+    QueueOps locked_ops = {"mutex", &locked, locked_enqueue, locked_dequeue};
+    QueueOps spsc_ops = {"spsc", &spsc, spsc_enqueue_op, spsc_dequeue_op};
+    QueueOps mpmc_ops = {"mpmc", &mpmc, mpmc_enqueue_op, mpmc_dequeue_op};
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int max_pairs = cpus > 1 ? (int)cpus : 2;
+    if (max_pairs > BENCH_MAX_PAIRS)
+    {
+        max_pairs = BENCH_MAX_PAIRS;
+    }
+
+    printf("%-10s %6s %10s %12s %10s %10s\n", "queue", "pairs", "time (ms)", "Mops/s", "p50 (ns)", "p99 (ns)");
+    run(&spsc_ops, 1);
+    for (int pairs = 1; pairs <= max_pairs; pairs *= 2)
+    {
+        run(&locked_ops, pairs);
+        run(&mpmc_ops, pairs);
+    }
+
+    spsc_free(&spsc);
+    mpmc_free(&mpmc);
+    pthread_mutex_destroy(&locked.lock);
+    return 0;
+}
@@ -0,0 +1,368 @@
+// Unified microbenchmark suite for the ds_header.h structures
+// Times stack push/pop, queue enqueue/dequeue, list insert/search, heap
+// insert/extract and bitmap scans at sizes 10^2 .. 10^7 and writes one CSV
+// row per (structure, variant, op, size) to stdout. The fixed MAX_SIZE
+// structures only run at sizes that fit.
+// Build and run with: make bench (writes bench_results.csv)
+// or: make bench_suite && ./bench_suite [max_size] > results.csv
+
+#define _POSIX_C_SOURCE 200809L
+#include "ds_header.h"
+#include "bench_harness.h"
+
+#define BENCH_MIN_SIZE 100L
+#define BENCH_MAX_SIZE 10000000L
+#define BENCH_REP_OPS 1000000L      // repetitions per size = this / size, at least 1
+#define BENCH_MAX_REPS 1000
+#define BENCH_SCAN_BITS 1000000L    // bits visited per scan phase, sets the scan count
+#define BENCH_WALK_NODES 1000000L   // nodes visited per list walk phase
+
+static int *keys;                   // random keys shared by every case at a size
+static volatile long sink;          // keeps results from being optimized away
+
+//------------------------------------------------------------------//
+
+static long scans_for(long bits)
+{
+    long scans = BENCH_SCAN_BITS / bits;
+    return scans > 0 ? scans : 1;
+}
+
+/******************************************************************
+  STACK
+******************************************************************/
+
+static void case_stack_fixed(long n, BenchTimer *t)
+{
+    static Stack s;
+    init_stack(&s);
+
+    bench_begin(t);
+    for (long i = 0; i < n; i++)
+    {
+        push(&s, keys[i]);
+    }
+    bench_end(t, "push", n);
+
+    long sum = 0;
+    bench_begin(t);
+    for (long i = 0; i < n; i++)
+    {
+        sum += pop(&s);
+    }
+    bench_end(t, "pop", n);
+    sink += sum;
+}
+
+static void case_stack_dyn(long n, BenchTimer *t)
+{
+    DynStack s;
+    if (dstack_init(&s, 0) != 0)
+    {
+        return;
+    }
+
+    bench_begin(t);
+    for (long i = 0; i < n; i++)
+    {
+        dstack_push(&s, keys[i]);
+    }
+    bench_end(t, "push", n);
+
+    long sum = 0;
+    bench_begin(t);
+    for (long i = 0; i < n; i++)
+    {
+        sum += dstack_pop(&s);
+    }
+    bench_end(t, "pop", n);
+    sink += sum;
+    dstack_free(&s);
+}
+
+/******************************************************************
+  QUEUE
+******************************************************************/
+
+static void case_queue_fixed(long n, BenchTimer *t)
+{
+    static CircularQueue q;
+    init_queue(&q);
+
+    bench_begin(t);
+    for (long i = 0; i < n; i++)
+    {
+        enqueue(&q, keys[i]);
+    }
+    bench_end(t, "enqueue", n);
+
+    long sum = 0;
+    bench_begin(t);
+    for (long i = 0; i < n; i++)
+    {
+        sum += dequeue(&q);
+    }
+    bench_end(t, "dequeue", n);
+    sink += sum;
+}
+
+static void case_queue_dyn(long n, BenchTimer *t)
+{
+    DynQueue q;
+    if (dqueue_init(&q, 0) != 0)
+    {
+        return;
+    }
+
+    bench_begin(t);
+    for (long i = 0; i < n; i++)
+    {
+        dqueue_enqueue(&q, keys[i]);
+    }
+    bench_end(t, "enqueue", n);
+
+    long sum = 0;
+    bench_begin(t);
+    for (long i = 0; i < n; i++)
+    {
+        sum += dqueue_dequeue(&q);
+    }
+    bench_end(t, "dequeue", n);
+    sink += sum;
+    dqueue_free(&q);
+}
+
+/******************************************************************
+  LIST
+******************************************************************/
+
+static void run_list(long n, BenchTimer *t, int indexed)
+{
+    CircularList list;
+    if (list_init(&list, indexed) != 0)
+    {
+        return;
+    }
+
+    bench_begin(t);
+    for (long i = 0; i < n; i++)
+    {
+        list_append(&list, keys[i]);
+    }
+    bench_end(t, "insert", n);
+
+    // without the index each search walks, so bound the nodes visited;
+    // keys are spread over the list starting mid-way, not at the head
+    long searches = indexed ? n : BENCH_WALK_NODES / n + 1;
+    long found = 0;
+    bench_begin(t);
+    for (long i = 0; i < searches; i++)
+    {
+        found += list_search(&list, keys[(i * 7919 + n / 2) % n]) != NULL;
+    }
+    bench_end(t, "search", searches);
+    sink += found;
+    list_free(&list);
+}
+
+static void case_list_tail(long n, BenchTimer *t)
+{
+    run_list(n, t, 0);
+}
+
+static void case_list_indexed(long n, BenchTimer *t)
+{
+    run_list(n, t, 1);
+}
+
+/******************************************************************
+  HEAP
+******************************************************************/
+
+static void run_heap(long n, BenchTimer *t, int kind)
+{
+    static PriorityQueue pq;
+    if (pq_init(&pq, kind) != 0)
+    {
+        return;
+    }
+
+    bench_begin(t);
+    for (long i = 0; i < n; i++)
+    {
+        HeapNode node = {(int)i, keys[i]};
+        pq_insert(&pq, node);
+    }
+    bench_end(t, "insert", n);
+
+    long sum = 0;
+    bench_begin(t);
+    for (long i = 0; i < n; i++)
+    {
+        sum += pq_extract_min(&pq).priority;
+    }
+    bench_end(t, "extract_min", n);
+    sink += sum;
+    pq_free(&pq);
+}
+
+static void case_heap_binary(long n, BenchTimer *t)
+{
+    run_heap(n, t, PQ_BINARY);
+}
+
+static void case_heap_dary(long n, BenchTimer *t)
+{
+    run_heap(n, t, PQ_DARY);
+}
+
+static void case_heap_pairing(long n, BenchTimer *t)
+{
+    run_heap(n, t, PQ_PAIRING);
+}
+
+/******************************************************************
+  BITMAP - worst-case scans: the only zero is the last bit
+******************************************************************/
+
+static void case_bitmap_flat(long n, BenchTimer *t)
+{
+    Bitmap bm;
+    if (bitmap_init(&bm, (int)n) != 0)
+    {
+        return;
+    }
+    bitmap_set_range(&bm, 0, (int)n - 1);
+    long scans = scans_for(n);
+    long sum = 0;
+
+    bench_begin(t);
+    for (long i = 0; i < scans; i++)
+    {
+        sum += bitmap_find_first_zero_bit(&bm);
+    }
+    bench_end(t, "find_first_zero", scans);
+
+    bench_begin(t);
+    for (long i = 0; i < scans; i++)
+    {
+        sum += bitmap_count_range(&bm, 0, (int)n);
+    }
+    bench_end(t, "count", scans);
+
+    bench_begin(t);
+    for (long i = 0; i < scans; i++)
+    {
+        sum += bitmap_find_zero_run(&bm, 2);
+    }
+    bench_end(t, "find_zero_run", scans);
+
+    // next set bit over a bitmap whose only set bit is the last one
+    bitmap_clear_range(&bm, 0, (int)n);
+    bitmap_set_bit(&bm, (int)n - 1);
+    bench_begin(t);
+    for (long i = 0; i < scans; i++)
+    {
+        sum += bitmap_find_next_set_bit(&bm, 0);
+    }
+    bench_end(t, "find_next_set", scans);
+    sink += sum;
+    bitmap_free(&bm);
+}
+
+static void case_bitmap_hier(long n, BenchTimer *t)
+{
+    HierBitmap hb;
+    if (hbitmap_init(&hb, (int)n) != 0)
+    {
+        return;
+    }
+    for (long i = 0; i < n - 1; i++)
+    {
+        hbitmap_set_bit(&hb, (int)i);
+    }
+    long scans = scans_for(n);
+    long sum = 0;
+
+    bench_begin(t);
+    for (long i = 0; i < scans; i++)
+    {
+        sum += hbitmap_find_first_zero_bit(&hb);
+    }
+    bench_end(t, "find_first_zero", scans);
+
+    // allocate and release the last free bit
+    bench_begin(t);
+    for (long i = 0; i < scans; i++)
+    {
+        int bit = hbitmap_alloc_bit(&hb);
+        hbitmap_clear_bit(&hb, bit);
+        sum += bit;
+    }
+    bench_end(t, "alloc_free", scans);
+    sink += sum;
+    hbitmap_free(&hb);
+}
+
+//------------------------------------------------------------------//
+
+typedef struct {
+    const char *structure;
+    const char *variant;
+    BenchCase fn;
+    long max_size;
+} SuiteEntry;
+
+static const SuiteEntry suite[] = {
+    {"stack", "fixed", case_stack_fixed, MAX_SIZE},
+    {"stack", "growable", case_stack_dyn, BENCH_MAX_SIZE},
+    {"queue", "fixed", case_queue_fixed, MAX_SIZE},
+    {"queue", "growable", case_queue_dyn, BENCH_MAX_SIZE},
+    {"list", "tail", case_list_tail, BENCH_MAX_SIZE},
+    {"list", "indexed", case_list_indexed, BENCH_MAX_SIZE},
+    {"heap", "binary", case_heap_binary, MAX_SIZE},
+    {"heap", "4-ary", case_heap_dary, BENCH_MAX_SIZE},
+    {"heap", "pairing", case_heap_pairing, BENCH_MAX_SIZE},
+    {"bitmap", "flat", case_bitmap_flat, BENCH_MAX_SIZE},
+    {"bitmap", "hier", case_bitmap_hier, BENCH_MAX_SIZE},
+};
+
+int main(int argc, char *argv[])
+{
+    long max_size = argc > 1 ? atol(argv[1]) : BENCH_MAX_SIZE;
+    if (max_size < BENCH_MIN_SIZE || max_size > BENCH_MAX_SIZE)
+    {
+        fprintf(stderr, "usage: %s [max_size %ld..%ld]\n", argv[0], BENCH_MIN_SIZE, BENCH_MAX_SIZE);
+        return 1;
+    }
+
+    keys = (int *)malloc((size_t)max_size * sizeof(int));
+    if (keys == NULL)
+    {
+        fprintf(stderr, "Error - could not allocate keys\n");
+        return 1;
+    }
+    srand(42);
+    for (long i = 0; i < max_size; i++)
+    {
+        keys[i] = rand();
+    }
+
+    bench_calibrate();
+    bench_csv_header(stdout);
+    for (long size = BENCH_MIN_SIZE; size <= max_size; size *= 10)
+    {
+        long reps = BENCH_REP_OPS / size;
+        reps = reps < 1 ? 1 : reps > BENCH_MAX_REPS ? BENCH_MAX_REPS : reps;
+        for (size_t i = 0; i < sizeof(suite) / sizeof(suite[0]); i++)
+        {
+            if (size <= suite[i].max_size)
+            {
+                bench_case(stdout, suite[i].structure, suite[i].variant, suite[i].fn, size, (int)reps);
+            }
+        }
+    }
+
+    free(keys);
+    return 0;
+}
@@ -16,7 +16,11 @@ void to_uppercase(char *str) {
     }
 }
 
-int main() {
+int main(int argc, char *argv[]) {
+    // Batch mode for long traces: ./kernelDS --replay [file]
+    if (argc > 1 && strcmp(argv[1], "--replay") == 0)
+        return replay_run(argc > 2 ? argv[2] : "TESTCASES.txt");
+
     Stack s;
     CircularQueue q;
     Node *list_head = NULL;
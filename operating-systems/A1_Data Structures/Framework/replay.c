@@ -0,0 +1,555 @@
+// Batch replay engine for the driver
+// Reads a whole trace into memory, tokenizes it once into a compact opcode
+// array, then runs it through a table of handlers with stdout fully
+// buffered. Output matches the line-by-line driver exactly; timing goes to
+// stderr. Run with: ./kernelDS --replay [TESTCASES.txt]
+
+#define _POSIX_C_SOURCE 200809L
+#include "ds_header.h"
+#include <time.h>
+
+#define REPLAY_OUT_BUFFER (1 << 20)
+
+enum {
+    S_STACK, S_QUEUE, S_LIST, S_HEAP, S_BITMAP, S_OTHER, S_COUNT
+};
+
+static const char *structure_names[S_COUNT] = {
+    "STACK", "QUEUE", "LIST", "HEAP", "BITMAP", "UNKNOWN"
+};
+
+typedef struct {
+    int op;
+    int a;          // first argument, or offset of the line text for unknown commands
+    int b;          // second argument, or 1 if an unknown line kept its newline
+} ReplayOp;
+
+typedef struct {
+    Stack s;
+    CircularQueue q;
+    Node *list_head;
+    MinHeap heap;
+    const char *text;
+} ReplayState;
+
+typedef void (*ReplayHandler)(ReplayState *st, const ReplayOp *op);
+
+/******************************************************************
+  HANDLERS - same messages as the line-by-line driver
+******************************************************************/
+
+static void op_push(ReplayState *st, const ReplayOp *op) {
+    if (push(&st->s, op->a) == -1)
+        printf("STACK: Error - Stack Overflow\n");
+    else
+        printf("STACK: Pushed into stack: %d\n", op->a);
+}
+
+static void op_pop(ReplayState *st, const ReplayOp *op) {
+    (void)op;
+    int result = pop(&st->s);
+    if (result == -1)
+        printf("STACK: Error - Stack Empty\n");
+    else
+        printf("STACK: Popped from stack: %d\n", result);
+}
+
+static void op_peek_stack(ReplayState *st, const ReplayOp *op) {
+    (void)op;
+    int result = peek_stack(&st->s);
+    if (result == -1)
+        printf("STACK: Error - Stack Empty\n");
+    else
+        printf("STACK: Top of stack: %d\n", result);
+}
+
+static void op_is_stack_empty(ReplayState *st, const ReplayOp *op) {
+    (void)op;
+    printf("STACK: Stack empty: %s\n", is_stack_empty(&st->s) ? "Yes" : "No");
+}
+
+static void op_is_stack_full(ReplayState *st, const ReplayOp *op) {
+    (void)op;
+    printf("STACK: Stack full: %s\n", is_stack_full(&st->s) ? "Yes" : "No");
+}
+
+static void op_stack_size(ReplayState *st, const ReplayOp *op) {
+    (void)op;
+    printf("STACK: Stack size: %d\n", stack_size(&st->s));
+}
+
+static void op_list_stack_elements(ReplayState *st, const ReplayOp *op) {
+    (void)op;
+    if (is_stack_empty(&st->s)) {
+        printf("STACK: Error - Stack Empty\n");
+    } else {
+        printf("STACK: Stack elements from top to bottom: ");
+        list_stack_elements(&st->s);
+        printf("\n");
+    }
+}
+
+static void op_enqueue(ReplayState *st, const ReplayOp *op) {
+    if (enqueue(&st->q, op->a) == -1)
+        printf("QUEUE: Error - Queue Full\n");
+    else
+        printf("QUEUE: Enqueued: %d\n", op->a);
+}
+
+static void op_dequeue(ReplayState *st, const ReplayOp *op) {
+    (void)op;
+    int result = dequeue(&st->q);
+    if (result == -1)
+        printf("QUEUE: Error - Queue Empty\n");
+    else
+        printf("QUEUE: Dequeued: %d\n", result);
+}
+
+static void op_peek_queue(ReplayState *st, const ReplayOp *op) {
+    (void)op;
+    int result = peek_queue(&st->q);
+    if (result == -1)
+        printf("QUEUE: Error - Queue Empty\n");
+    else
+        printf("QUEUE: Front of queue: %d\n", result);
+}
+
+static void op_is_queue_empty(ReplayState *st, const ReplayOp *op) {
+    (void)op;
+    printf("QUEUE: Queue empty: %s\n", is_queue_empty(&st->q) ? "Yes" : "No");
+}
+
+static void op_is_queue_full(ReplayState *st, const ReplayOp *op) {
+    (void)op;
+    printf("QUEUE: Queue full: %s\n", is_queue_full(&st->q) ? "Yes" : "No");
+}
+
+static void op_queue_size(ReplayState *st, const ReplayOp *op) {
+    (void)op;
+    printf("QUEUE: Queue size: %d\n", queue_size(&st->q));
+}
+
+static void op_list_queue_elements(ReplayState *st, const ReplayOp *op) {
+    (void)op;
+    if (is_queue_empty(&st->q)) {
+        printf("QUEUE: Error - Queue Empty\n");
+    } else {
+        printf("QUEUE: Queue elements from front to rear: ");
+        list_queue_elements(&st->q);
+        printf("\n");
+    }
+}
+
+static void op_insert_node(ReplayState *st, const ReplayOp *op) {
+    st->list_head = insert_node(st->list_head, create_node(op->a));
+    printf("LIST: Node inserted is: %d\n", op->a);
+}
+
+static void op_delete_node(ReplayState *st, const ReplayOp *op) {
+    st->list_head = delete_node(st->list_head, op->a);
+    printf("LIST: Node deleted is: %d\n", op->a);
+}
+
+static void op_search_node(ReplayState *st, const ReplayOp *op) {
+    Node *found = search_node(st->list_head, op->a);
+    printf("LIST: Node %d %s\n", op->a, found ? "found" : "not found");
+}
+
+static void op_iterate_list(ReplayState *st, const ReplayOp *op) {
+    (void)op;
+    if (is_list_empty(st->list_head)) {
+        printf("LIST: List is empty\n");
+    } else {
+        printf("LIST: List nodes are: ");
+        iterate_list(st->list_head);
+        printf("\n");
+    }
+}
+
+static void op_is_list_empty(ReplayState *st, const ReplayOp *op) {
+    (void)op;
+    printf("LIST: List empty: %s\n", is_list_empty(st->list_head) ? "Yes" : "No");
+}
+
+static void op_free_list(ReplayState *st, const ReplayOp *op) {
+    (void)op;
+    if (free_list(st->list_head) == -1)
+        printf("LIST: List is already empty\n");
+    else
+        printf("LIST: List has been emptied\n");
+    st->list_head = NULL;
+}
+
+static void op_insert_element(ReplayState *st, const ReplayOp *op) {
+    HeapNode node = {op->a, op->b};
+    insert_element(&st->heap, node);
+    printf("HEAP: Inserted element: value=%d, priority=%d\n", op->a, op->b);
+}
+
+static void op_extract_min(ReplayState *st, const ReplayOp *op) {
+    (void)op;
+    if (st->heap.size == 0) {
+        printf("HEAP: Error - Heap Empty\n");
+    } else {
+        HeapNode min = extract_min(&st->heap);
+        printf("HEAP: Extracted min: value=%d, priority=%d\n", min.value, min.priority);
+    }
+}
+
+static void op_peek_heap(ReplayState *st, const ReplayOp *op) {
+    (void)op;
+    if (st->heap.size == 0) {
+        printf("HEAP: Error - Heap Empty\n");
+    } else {
+        HeapNode min = peek_heap(&st->heap);
+        printf("HEAP: Top of heap: value=%d, priority=%d\n", min.value, min.priority);
+    }
+}
+
+static void op_decrease_key(ReplayState *st, const ReplayOp *op) {
+    if (decrease_key(&st->heap, op->a, op->b) == -2)
+        printf("HEAP: Error - New priority is higher than current\n");
+    else
+        printf("HEAP: Decreased priority of element at index %d to %d\n", op->a, op->b);
+}
+
+static void op_remove_element(ReplayState *st, const ReplayOp *op) {
+    remove_element(&st->heap, op->a);
+    printf("HEAP: Removed element at index %d\n", op->a);
+}
+
+static void op_is_heap_empty(ReplayState *st, const ReplayOp *op) {
+    (void)op;
+    printf("HEAP: Heap empty: %s\n", is_heap_empty(&st->heap) ? "Yes" : "No");
+}
+
+static void op_list_heap_elements(ReplayState *st, const ReplayOp *op) {
+    (void)op;
+    if (is_heap_empty(&st->heap)) {
+        printf("HEAP: Error - Heap Empty\n");
+    } else {
+        printf("HEAP: Heap elements (Index[i], Value[v], Priority[p]): ");
+        list_heap_elements(&st->heap);
+        printf("\n");
+    }
+}
+
+static void op_init_bitmap(ReplayState *st, const ReplayOp *op) {
+    (void)st;
+    init_bitmap(op->a);
+    printf("BITMAP: Initialized bitmap with %d bits\n", op->a);
+}
+
+static void op_set_bit(ReplayState *st, const ReplayOp *op) {
+    (void)st;
+    set_bit(op->a);
+    printf("BITMAP: Set bit %d\n", op->a);
+}
+
+static void op_clear_bit(ReplayState *st, const ReplayOp *op) {
+    (void)st;
+    clear_bit(op->a);
+    printf("BITMAP: Cleared bit %d\n", op->a);
+}
+
+static void op_test_bit(ReplayState *st, const ReplayOp *op) {
+    (void)st;
+    int result = test_bit(op->a);
+    if (result == -1)
+        printf("BITMAP: Error - Invalid bit index %d\n", op->a);
+    else
+        printf("BITMAP: Bit %d is %s\n", op->a, result ? "set" : "clear");
+}
+
+static void op_find_first_zero_bit(ReplayState *st, const ReplayOp *op) {
+    (void)st;
+    (void)op;
+    int result = find_first_zero_bit();
+    if (result == -1)
+        printf("BITMAP: No zero bits found\n");
+    else
+        printf("BITMAP: First zero bit at position: %d\n", result);
+}
+
+static void op_find_next_set_bit(ReplayState *st, const ReplayOp *op) {
+    (void)st;
+    int result = find_next_set_bit(op->a);
+    if (result == -1)
+        printf("BITMAP: No set bit found after position %d\n", op->a);
+    else
+        printf("BITMAP: Next set bit after %d is at position: %d\n", op->a, result);
+}
+
+static void op_print_bitmap(ReplayState *st, const ReplayOp *op) {
+    (void)st;
+    (void)op;
+    printf("BITMAP: ");
+    print_bitmap();
+    printf("\n");
+}
+
+static void op_is_bitmap_empty(ReplayState *st, const ReplayOp *op) {
+    (void)st;
+    (void)op;
+    printf("BITMAP: Bitmap empty: %s\n", is_bitmap_empty() ? "Yes" : "No");
+}
+
+static void op_bitmap_size(ReplayState *st, const ReplayOp *op) {
+    (void)st;
+    (void)op;
+    printf("BITMAP: Bitmap size: %d bits\n", bitmap_size());
+}
+
+static void op_unknown(ReplayState *st, const ReplayOp *op) {
+    // b is set when the driver would have kept the line's own newline
+    printf("UNKNOWN: %s%s\n", st->text + op->a, op->b ? "\n" : "");
+}
+
+/******************************************************************
+  COMMAND TABLE - same order as the driver's strncmp chain, since
+  matching is by prefix and the first hit wins
+******************************************************************/
+
+typedef struct {
+    const char *name;
+    int len;
+    int nargs;
+    int structure;
+    ReplayHandler handler;
+} ReplayCommand;
+
+#define CMD(name, nargs, structure, handler) { name, (int)sizeof(name) - 1, nargs, structure, handler }
+
+static const ReplayCommand commands[] = {
+    CMD("PUSH", 1, S_STACK, op_push),
+    CMD("POP", 0, S_STACK, op_pop),
+    CMD("PEEK_STACK", 0, S_STACK, op_peek_stack),
+    CMD("IS_STACK_EMPTY", 0, S_STACK, op_is_stack_empty),
+    CMD("IS_STACK_FULL", 0, S_STACK, op_is_stack_full),
+    CMD("STACK_SIZE", 0, S_STACK, op_stack_size),
+    CMD("LIST_STACK_ELEMENTS", 0, S_STACK, op_list_stack_elements),
+    CMD("ENQUEUE", 1, S_QUEUE, op_enqueue),
+    CMD("DEQUEUE", 0, S_QUEUE, op_dequeue),
+    CMD("PEEK_QUEUE", 0, S_QUEUE, op_peek_queue),
+    CMD("IS_QUEUE_EMPTY", 0, S_QUEUE, op_is_queue_empty),
+    CMD("IS_QUEUE_FULL", 0, S_QUEUE, op_is_queue_full),
+    CMD("QUEUE_SIZE", 0, S_QUEUE, op_queue_size),
+    CMD("LIST_QUEUE_ELEMENTS", 0, S_QUEUE, op_list_queue_elements),
+    CMD("INSERT_NODE", 1, S_LIST, op_insert_node),
+    CMD("DELETE_NODE", 1, S_LIST, op_delete_node),
+    CMD("SEARCH_NODE", 1, S_LIST, op_search_node),
+    CMD("ITERATE_LIST", 0, S_LIST, op_iterate_list),
+    CMD("IS_LIST_EMPTY", 0, S_LIST, op_is_list_empty),
+    CMD("FREE_LIST", 0, S_LIST, op_free_list),
+    CMD("INSERT_ELEMENT", 2, S_HEAP, op_insert_element),
+    CMD("EXTRACT_MIN", 0, S_HEAP, op_extract_min),
+    CMD("PEEK_HEAP", 0, S_HEAP, op_peek_heap),
+    CMD("DECREASE_KEY", 2, S_HEAP, op_decrease_key),
+    CMD("REMOVE_ELEMENT", 1, S_HEAP, op_remove_element),
+    CMD("IS_HEAP_EMPTY", 0, S_HEAP, op_is_heap_empty),
+    CMD("LIST_HEAP_ELEMENTS", 0, S_HEAP, op_list_heap_elements),
+    CMD("INIT_BITMAP", 1, S_BITMAP, op_init_bitmap),
+    CMD("SET_BIT", 1, S_BITMAP, op_set_bit),
+    CMD("CLEAR_BIT", 1, S_BITMAP, op_clear_bit),
+    CMD("TEST_BIT", 1, S_BITMAP, op_test_bit),
+    CMD("FIND_FIRST_ZERO_BIT", 0, S_BITMAP, op_find_first_zero_bit),
+    CMD("FIND_NEXT_SET_BIT", 1, S_BITMAP, op_find_next_set_bit),
+    CMD("PRINT_BITMAP", 0, S_BITMAP, op_print_bitmap),
+    CMD("IS_BITMAP_EMPTY", 0, S_BITMAP, op_is_bitmap_empty),
+    CMD("BITMAP_SIZE", 0, S_BITMAP, op_bitmap_size),
+    CMD("", 0, S_OTHER, op_unknown),
+};
+
+#define NUM_COMMANDS ((int)(sizeof(commands) / sizeof(commands[0])))
+#define OP_UNKNOWN (NUM_COMMANDS - 1)
+#define ASCII_UPPER(c) ((c) >= 'a' && (c) <= 'z' ? (char)((c) - 'a' + 'A') : (c))
+
+//------------------------------------------------------------------//
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * match_command - Find the opcode of a trimmed line
+ * @return: Index into commands[], OP_UNKNOWN if nothing matches
+ */
+static int match_command(const char *line) {
+    char first = ASCII_UPPER(line[0]);
+    for (int i = 0; i < OP_UNKNOWN; i++) {
+        if (commands[i].name[0] != first)
+            continue;
+        int k = 1;
+        while (k < commands[i].len && ASCII_UPPER(line[k]) == commands[i].name[k])
+            k++;
+        if (k == commands[i].len)
+            return i;
+    }
+    return OP_UNKNOWN;
+}
+
+/**
+ * parse_int - Read one integer like sscanf("%d"), 0 if there is none
+ *
+ * The driver leaves the variable unset in that case and prints garbage.
+ */
+static int parse_int(char **p) {
+    char *end;
+    long val = strtol(*p, &end, 10);
+    if (end == *p)
+        return 0;
+    *p = end;
+    return (int)val;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * tokenize - Turn the trace text into an opcode array, in place
+ * @param text: Whole file, NUL-terminated; lines are split and trimmed
+ *
+ * Lines are taken whole; the driver's fgets would split lines longer
+ * than LINE_LENGTH - 1 characters.
+ * @param count: Receives the number of ops
+ * @return: Malloc'd op array, NULL on allocation failure
+ */
+static ReplayOp *tokenize(char *text, long size, long *count) {
+    long lines = 1;
+    for (long i = 0; i < size; i++)
+        if (text[i] == '\n')
+            lines++;
+
+    ReplayOp *ops = (ReplayOp *)malloc((size_t)lines * sizeof(ReplayOp));
+    if (ops == NULL)
+        return NULL;
+
+    long n = 0;
+    char *line = text;
+    while (line != NULL) {
+        char *newline = strchr(line, '\n');
+        if (newline != NULL)
+            *newline = '\0';
+
+        // same rules as the driver's trim(): trailing whitespace goes, but
+        // leading whitespace stays, and a whitespace-only line is left alone
+        // (newline included) and so reports as UNKNOWN
+        char *end = line + strlen(line);
+        int blank = 1;
+        for (char *c = line; c < end; c++) {
+            if (!isspace((unsigned char)*c)) {
+                blank = 0;
+                break;
+            }
+        }
+        if (!blank) {
+            while (end > line && isspace((unsigned char)end[-1]))
+                end--;
+            *end = '\0';
+        }
+
+        if (line[0] != '/' && line[0] != '+' && !(line[0] == '\0' && newline == NULL)) {
+            int op = match_command(line);
+            ReplayOp *out = &ops[n++];
+            out->op = op;
+            out->a = 0;
+            out->b = 0;
+            if (op == OP_UNKNOWN) {
+                out->a = (int)(line - text);
+                out->b = blank && newline != NULL;
+            } else if (commands[op].nargs > 0 && commands[op].len < (int)(end - line)) {
+                // arguments start one past the command, as in the driver
+                char *args = line + commands[op].len + 1;
+                out->a = parse_int(&args);
+                if (commands[op].nargs > 1)
+                    out->b = parse_int(&args);
+            }
+        }
+        line = newline != NULL ? newline + 1 : NULL;
+    }
+
+    *count = n;
+    return ops;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * replay_run - Replay a trace file through the batch engine
+ * @param path: Trace in TESTCASES.txt format
+ * @return: 0 on success, 1 if the file could not be read
+ */
+int replay_run(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        printf("Error opening %s", path);
+        return 1;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *text = (char *)malloc((size_t)(size > 0 ? size : 0) + 1);
+    if (text == NULL || size < 0 || (long)fread(text, 1, (size_t)size, file) != size) {
+        printf("Error reading %s", path);
+        free(text);
+        fclose(file);
+        return 1;
+    }
+    fclose(file);
+    text[size] = '\0';
+
+    double t0 = now_sec();
+    long count = 0;
+    ReplayOp *ops = tokenize(text, size, &count);
+    if (ops == NULL) {
+        printf("Error - could not allocate %s ops", path);
+        free(text);
+        return 1;
+    }
+    double parse_sec = now_sec() - t0;
+
+    static char out_buffer[REPLAY_OUT_BUFFER];
+    setvbuf(stdout, out_buffer, _IOFBF, sizeof(out_buffer));
+
+    static ReplayState st;
+    init_stack(&st.s);
+    init_queue(&st.q);
+    st.list_head = NULL;
+    st.heap.size = 0;
+    st.text = text;
+
+    // time runs of consecutive ops on the same structure; a clock read per
+    // switch keeps the overhead off ops that are not switches
+    double elapsed[S_COUNT] = {0};
+    long executed[S_COUNT] = {0};
+    int current = S_OTHER;
+    double mark = now_sec();
+    for (long i = 0; i < count; i++) {
+        const ReplayCommand *cmd = &commands[ops[i].op];
+        if (cmd->structure != current) {
+            double now = now_sec();
+            elapsed[current] += now - mark;
+            mark = now;
+            current = cmd->structure;
+        }
+        executed[current]++;
+        cmd->handler(&st, &ops[i]);
+    }
+    fflush(stdout);
+    double now = now_sec();
+    elapsed[current] += now - mark;
+    double run_sec = now - t0 - parse_sec;
+
+    fprintf(stderr, "REPLAY: %ld ops, tokenize %.2f ms, run %.2f ms, %.0f ops/sec\n",
+            count, parse_sec * 1e3, run_sec * 1e3, run_sec > 0 ? (double)count / run_sec : 0.0);
+    for (int s = 0; s < S_COUNT; s++) {
+        if (executed[s] > 0)
+            fprintf(stderr, "REPLAY: %-7s %10ld ops %12.0f ops/sec\n", structure_names[s], executed[s],
+                    elapsed[s] > 0 ? (double)executed[s] / elapsed[s] : 0.0);
+    }
+
+    free(ops);
+    free(text);
+    return 0;
+}
@@ -0,0 +1,115 @@
+// AtomicBitmap multithreaded stress test
+// Threads claim and release bits concurrently and check that no bit is
+// ever handed to two owners at once.
+// Build and run with: make test_atomic_bitmap && ./test_atomic_bitmap
+
+#define _POSIX_C_SOURCE 200809L
+#include "ds_header.h"
+#include <pthread.h>
+
+#define STRESS_THREADS 8
+#define STRESS_BITS 4099        // not a multiple of 64, exercises the padding
+#define STRESS_ROUNDS 200000    // claim/release pairs per thread
+#define STRESS_HOLD 16          // bits each thread holds before releasing
+
+static AtomicBitmap bitmap;
+static _Atomic int owner[STRESS_BITS]; // thread id + 1 holding each bit, 0 if free
+static _Atomic int failures;
+
+//------------------------------------------------------------------//
+
+static void *stress_worker(void *arg)
+{
+    int id = (int)(long)arg + 1;
+    int held[STRESS_HOLD];
+    int nheld = 0;
+
+    for (int round = 0; round < STRESS_ROUNDS; round++)
+    {
+        if (nheld < STRESS_HOLD)
+        {
+            int n = abitmap_claim_bit(&bitmap);
+            if (n < 0 || n >= STRESS_BITS)
+            {
+                // the bitmap is far larger than all holdings combined
+                atomic_fetch_add(&failures, 1);
+                continue;
+            }
+            int expected = 0;
+            if (!atomic_compare_exchange_strong(&owner[n], &expected, id))
+            {
+                printf("Error - bit %d claimed by thread %d while held by %d\n", n, id, expected);
+                atomic_fetch_add(&failures, 1);
+                continue;
+            }
+            held[nheld++] = n;
+        }
+        else
+        {
+            // release a bit picked from the middle to mix the pattern
+            int slot = round % STRESS_HOLD;
+            int n = held[slot];
+            held[slot] = held[--nheld];
+            atomic_store(&owner[n], 0);
+            if (abitmap_clear_bit(&bitmap, n) != 1)
+            {
+                printf("Error - bit %d was already clear on release\n", n);
+                atomic_fetch_add(&failures, 1);
+            }
+        }
+    }
+
+    // leave every held bit in place for the final count check
+    return (void *)(long)nheld;
+}
+
+//------------------------------------------------------------------//
+
+int main(void)
+{
+    pthread_t threads[STRESS_THREADS];
+    long held_total = 0;
+
+    if (abitmap_init(&bitmap, STRESS_BITS) != 0)
+    {
+        printf("Error - could not allocate bitmap\n");
+        return 1;
+    }
+
+    for (long t = 0; t < STRESS_THREADS; t++)
+    {
+        pthread_create(&threads[t], NULL, stress_worker, (void *)t);
+    }
+    for (int t = 0; t < STRESS_THREADS; t++)
+    {
+        void *held;
+        pthread_join(threads[t], &held);
+        held_total += (long)held;
+    }
+
+    int count = abitmap_count_set_bits(&bitmap);
+    if (count != held_total)
+    {
+        printf("Error - %d bits set, threads hold %ld\n", count, held_total);
+        atomic_fetch_add(&failures, 1);
+    }
+
+    // single-threaded: fill to the last bit, then the bitmap must report full
+    while (abitmap_claim_bit(&bitmap) >= 0)
+    {
+    }
+    if (abitmap_count_set_bits(&bitmap) != STRESS_BITS)
+    {
+        printf("Error - full bitmap has %d of %d bits set\n", abitmap_count_set_bits(&bitmap), STRESS_BITS);
+        atomic_fetch_add(&failures, 1);
+    }
+
+    abitmap_free(&bitmap);
+    if (atomic_load(&failures) != 0)
+    {
+        printf("ATOMIC BITMAP: FAILED (%d errors)\n", atomic_load(&failures));
+        return 1;
+    }
+    printf("ATOMIC BITMAP: %d threads x %d rounds passed\n", STRESS_THREADS, STRESS_ROUNDS);
+    return 0;
+}
@@ -0,0 +1,197 @@
+// Atomic Bitmap - lock-free bitmap built on C11 atomics
+// See ds_header.h for structure and prototype definitions
+// Used in: concurrent page frame allocation
+
+#include "ds_header.h"
+
+// Word helpers - bit n lives in word n / 64 at position n % 64
+#define WORD_INDEX(n) ((n) / BITMAP_WORD_BITS)
+#define WORD_OFFSET(n) ((n) % BITMAP_WORD_BITS)
+#define WORD_MASK(n) (1ULL << WORD_OFFSET(n))
+#define WORD_CTZ(w) __builtin_ctzll(w)
+#define WORD_POPCOUNT(w) __builtin_popcountll(w)
+
+//------------------------------------------------------------------//
+
+/**
+ * abitmap_init - Allocate a zeroed atomic bitmap
+ * @param ab: Pointer to the bitmap to initialize
+ * @param nbits: Number of bits (must be > 0)
+ * @return: 0 on success, -1 on invalid size or allocation failure
+ *
+ * Not thread-safe: initialize before sharing the bitmap with other threads.
+ */
+int abitmap_init(AtomicBitmap *ab, int nbits)
+{
+    if (ab == NULL || nbits <= 0)
+    {
+        return -1;
+    }
+
+    int nwords = BITMAP_WORDS(nbits);
+    _Atomic uint64_t *words = (_Atomic uint64_t *)malloc((size_t)nwords * sizeof(_Atomic uint64_t));
+    if (words == NULL)
+    {
+        return -1;
+    }
+    for (int i = 0; i < nwords; i++)
+    {
+        atomic_init(&words[i], 0);
+    }
+
+    ab->words = words;
+    ab->nbits = nbits;
+    ab->nwords = nwords;
+    atomic_init(&ab->hint, 0);
+    return 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * abitmap_free - Release the storage of an atomic bitmap
+ * @param ab: Pointer to the bitmap
+ *
+ * Not thread-safe: no other thread may be using the bitmap.
+ */
+void abitmap_free(AtomicBitmap *ab)
+{
+    if (ab == NULL)
+    {
+        return;
+    }
+    free((void *)ab->words);
+    ab->words = NULL;
+    ab->nbits = 0;
+    ab->nwords = 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * abitmap_set_bit - Atomically set bit n to 1
+ * @param ab: Pointer to the bitmap
+ * @param n: Bit index to set (0-based)
+ * @return: Previous value of the bit (1/0), or -1 if invalid index
+ */
+int abitmap_set_bit(AtomicBitmap *ab, int n)
+{
+    if (ab == NULL || n < 0 || n >= ab->nbits)
+    {
+        return -1;
+    }
+    uint64_t old = atomic_fetch_or_explicit(&ab->words[WORD_INDEX(n)], WORD_MASK(n), memory_order_acq_rel);
+    return (old & WORD_MASK(n)) != 0 ? 1 : 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * abitmap_clear_bit - Atomically clear bit n to 0
+ * @param ab: Pointer to the bitmap
+ * @param n: Bit index to clear (0-based)
+ * @return: Previous value of the bit (1/0), or -1 if invalid index
+ */
+int abitmap_clear_bit(AtomicBitmap *ab, int n)
+{
+    if (ab == NULL || n < 0 || n >= ab->nbits)
+    {
+        return -1;
+    }
+    uint64_t old = atomic_fetch_and_explicit(&ab->words[WORD_INDEX(n)], ~WORD_MASK(n), memory_order_acq_rel);
+    return (old & WORD_MASK(n)) != 0 ? 1 : 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * abitmap_test_bit - Test if bit n is set
+ * @param ab: Pointer to the bitmap
+ * @param n: Bit index to test (0-based)
+ * @return: 1 if set, 0 if clear, -1 if invalid index
+ */
+int abitmap_test_bit(AtomicBitmap *ab, int n)
+{
+    if (ab == NULL || n < 0 || n >= ab->nbits)
+    {
+        return -1;
+    }
+    uint64_t word = atomic_load_explicit(&ab->words[WORD_INDEX(n)], memory_order_acquire);
+    return (word & WORD_MASK(n)) != 0 ? 1 : 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * abitmap_claim_bit - Atomically find a zero bit and set it
+ * @param ab: Pointer to the bitmap
+ * @return: Index of the claimed bit, or -1 if no zero bit was seen
+ *
+ * Scans one pass over all words starting at the hint. A bit released
+ * behind the scan while it runs may be missed, so -1 means "full at the
+ * time each word was looked at".
+ */
+int abitmap_claim_bit(AtomicBitmap *ab)
+{
+    if (ab == NULL || ab->nwords == 0)
+    {
+        return -1;
+    }
+
+    int last = ab->nwords - 1;
+    int start = atomic_load_explicit(&ab->hint, memory_order_relaxed);
+    if (start > last)
+    {
+        start = 0;
+    }
+
+    for (int step = 0; step <= last; step++)
+    {
+        int w = start + step <= last ? start + step : start + step - ab->nwords;
+        // padding bits past nbits count as used
+        uint64_t pad = w == last ? ~BITMAP_TAIL_MASK(ab->nbits) : 0;
+        uint64_t old = atomic_load_explicit(&ab->words[w], memory_order_relaxed);
+        uint64_t free_bits;
+
+        // retry on the same word while it still has a free bit; a failed
+        // CAS reloads old with the current value
+        while ((free_bits = ~(old | pad)) != 0)
+        {
+            uint64_t bit = free_bits & (~free_bits + 1);
+            if (atomic_compare_exchange_weak_explicit(&ab->words[w], &old, old | bit,
+                                                      memory_order_acq_rel, memory_order_relaxed))
+            {
+                if (w != start)
+                {
+                    atomic_store_explicit(&ab->hint, w, memory_order_relaxed);
+                }
+                return w * BITMAP_WORD_BITS + WORD_CTZ(bit);
+            }
+        }
+    }
+    return -1;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * abitmap_count_set_bits - Count set bits
+ * @param ab: Pointer to the bitmap
+ * @return: Number of set bits (a snapshot if other threads are active)
+ */
+int abitmap_count_set_bits(AtomicBitmap *ab)
+{
+    if (ab == NULL)
+    {
+        return 0;
+    }
+
+    int count = 0;
+    for (int i = 0; i < ab->nwords; i++)
+    {
+        count += WORD_POPCOUNT(atomic_load_explicit(&ab->words[i], memory_order_relaxed));
+    }
+    return count;
+}
+
+//------------------------------------------------------------------//
@@ -4,133 +4,213 @@
 
 #include "ds_header.h"
 
-// Global bitmap storage (defined in header file)
-unsigned char bitmap_data[MAX_BITMAP_BYTES] = {0};
-int current_bitmap_size = 0;
+// Word helpers - bit n lives in word n / 64 at position n % 64
+#define WORD_INDEX(n) ((n) / BITMAP_WORD_BITS)
+#define WORD_OFFSET(n) ((n) % BITMAP_WORD_BITS)
+#define WORD_MASK(n) (1ULL << WORD_OFFSET(n))
+#define WORD_CTZ(w) __builtin_ctzll(w)
+
+// Default instance used by the global API (init_bitmap, set_bit, ...)
+static Bitmap default_bitmap = {NULL, 0, 0};
 
 /******************************************************************
-    ⚠️PROVIDED IMPLEMENTATION -Students dont implement this!
+  WORD-AT-A-TIME BITMAP ENGINE - instance based, dynamically sized
 ******************************************************************/
+
+//------------------------------------------------------------------//
+
 /**
- * init_bitmap - Initialize bitmap with specified size
- * @param size: Number of bits in the bitmap (1 to MAX_BITMAP_BITS)
- *
- * PROVIDED IMPLEMENTATION - No need to implement this function
- * This function is provided to help students focus on core bit manipulation concepts
+ * bitmap_init - Allocate zeroed storage for a bitmap
+ * @param bm: Pointer to the bitmap to initialize
+ * @param nbits: Number of bits (must be > 0)
+ * @return: 0 on success, -1 on invalid size or allocation failure
  */
-void init_bitmap(int size)
+int bitmap_init(Bitmap *bm, int nbits)
+{
+    if (bm == NULL || nbits <= 0)
+    {
+        return -1;
+    }
+
+    int nwords = BITMAP_WORDS(nbits);
+    uint64_t *words = (uint64_t *)calloc((size_t)nwords, sizeof(uint64_t));
+    if (words == NULL)
+    {
+        return -1;
+    }
+
+    bm->words = words;
+    bm->nbits = nbits;
+    bm->nwords = nwords;
+    return 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * bitmap_free - Release the storage of a bitmap
+ * @param bm: Pointer to the bitmap (left with size 0)
+ */
+void bitmap_free(Bitmap *bm)
 {
-    // check size bounds
-    if (size <= 0 || size > MAX_BITMAP_BITS)
+    if (bm == NULL)
     {
         return;
     }
+    free(bm->words);
+    bm->words = NULL;
+    bm->nbits = 0;
+    bm->nwords = 0;
+}
 
-    current_bitmap_size = size;
+//------------------------------------------------------------------//
 
-    // calculate the bytes needed for 'size' bits
-    // 8 bits needs 1 byte, 10 bits needs 2 bytes
-    int bytesNeeded = (size + 7) / 8;
+/**
+ * bitmap_create - Heap-allocate and initialize a bitmap
+ * @param nbits: Number of bits (must be > 0)
+ * @return: Pointer to the new bitmap, or NULL on failure
+ */
+Bitmap *bitmap_create(int nbits)
+{
+    Bitmap *bm = (Bitmap *)malloc(sizeof(Bitmap));
+    if (bm == NULL)
+    {
+        return NULL;
+    }
+    if (bitmap_init(bm, nbits) != 0)
+    {
+        free(bm);
+        return NULL;
+    }
+    return bm;
+}
+
+//------------------------------------------------------------------//
 
-    // clear bytes
-    for (int i = 0; i < bytesNeeded; i++)
+/**
+ * bitmap_destroy - Free a bitmap returned by bitmap_create
+ * @param bm: Pointer to the bitmap
+ */
+void bitmap_destroy(Bitmap *bm)
+{
+    if (bm == NULL)
     {
-        bitmap_data[i] = 0; // init to zeros
+        return;
     }
+    bitmap_free(bm);
+    free(bm);
 }
 
-/******************************************************************
-  👍STUDENT IMPLEMENTATION -Students implement these 8 functions
-******************************************************************/
+//------------------------------------------------------------------//
+
+/**
+ * bitmap_resize - Change the number of bits, keeping existing bits
+ * @param bm: Pointer to the bitmap
+ * @param nbits: New number of bits (must be > 0)
+ * @return: 0 on success, -1 on invalid size or allocation failure
+ */
+int bitmap_resize(Bitmap *bm, int nbits)
+{
+    if (bm == NULL || nbits <= 0)
+    {
+        return -1;
+    }
+
+    int nwords = BITMAP_WORDS(nbits);
+    if (nwords != bm->nwords)
+    {
+        uint64_t *words = (uint64_t *)realloc(bm->words, (size_t)nwords * sizeof(uint64_t));
+        if (words == NULL)
+        {
+            return -1;
+        }
+        // zero the newly added words
+        if (nwords > bm->nwords)
+        {
+            memset(words + bm->nwords, 0, (size_t)(nwords - bm->nwords) * sizeof(uint64_t));
+        }
+        bm->words = words;
+        bm->nwords = nwords;
+    }
+
+    // shrinking drops bits past the new size so the tail stays zero
+    bm->nbits = nbits;
+    bm->words[nwords - 1] &= BITMAP_TAIL_MASK(nbits);
+    return 0;
+}
 
 //------------------------------------------------------------------//
 
 /**
- * set_bit - Set bit n to 1
+ * bitmap_set_bit - Set bit n to 1
+ * @param bm: Pointer to the bitmap
  * @param n: Bit index to set (0-based)
  */
-void set_bit(int n)
+void bitmap_set_bit(Bitmap *bm, int n)
 {
-    // TODO: Validate index and set the bit using bitwise OR
-    // Use: bitmap_data[n/8] |= (1 << (n%8))
-
-    // check bounds
-    if (n >= current_bitmap_size || n < 0)
+    if (bm == NULL || n < 0 || n >= bm->nbits)
     {
         return;
     }
-    // calculate the byte and bit position within the byte
-    int bytePos = n / 8;
-    int bitPos = n % 8;
-    // set the bit
-    bitmap_data[bytePos] |= (1 << bitPos);
+    bm->words[WORD_INDEX(n)] |= WORD_MASK(n);
 }
 
 //------------------------------------------------------------------//
 
 /**
- * clear_bit - Clear bit n to 0
+ * bitmap_clear_bit - Clear bit n to 0
+ * @param bm: Pointer to the bitmap
  * @param n: Bit index to clear (0-based)
  */
-void clear_bit(int n)
+void bitmap_clear_bit(Bitmap *bm, int n)
 {
-    // TODO: Validate index and clear the bit using bitwise AND with NOT
-    // Use: bitmap_data[n/8] &= ~(1 << (n%8))
-
-    // check bounds
-    if (n >= current_bitmap_size || n < 0)
+    if (bm == NULL || n < 0 || n >= bm->nbits)
     {
         return;
     }
-    // calculate byte and bit position
-    int bytePos = n / 8;
-    int bitPos = n % 8;
-    // clear the bit with bitwise and inverting
-    bitmap_data[bytePos] &= ~(1 << bitPos);
+    bm->words[WORD_INDEX(n)] &= ~WORD_MASK(n);
 }
 
 //------------------------------------------------------------------//
 
 /**
- * test_bit - Test if bit n is set
+ * bitmap_test_bit - Test if bit n is set
+ * @param bm: Pointer to the bitmap
  * @param n: Bit index to test (0-based)
  * @return: 1 if set, 0 if clear, -1 if invalid index
  */
-int test_bit(int n)
+int bitmap_test_bit(Bitmap *bm, int n)
 {
-    // TODO: Validate index and test the bit using bitwise AND
-    // Use: (bitmap_data[n/8] & (1 << (n%8))) != 0
-
-    // chcek bounds
-    if (n >= current_bitmap_size || n < 0)
+    if (bm == NULL || n < 0 || n >= bm->nbits)
     {
         return -1;
     }
-    // calc byte and bit positions
-    int bytePos = n / 8;
-    int bitPos = n % 8;
-
-    // returns 1 if bit is set and 0 if its cleared
-    return (bitmap_data[bytePos] & (1 << bitPos)) != 0 ? 1 : 0;
+    return (bm->words[WORD_INDEX(n)] & WORD_MASK(n)) != 0 ? 1 : 0;
 }
 
 //------------------------------------------------------------------//
 
 /**
- * find_first_zero_bit - Find first unset bit
+ * bitmap_find_first_zero_bit - Find first unset bit
+ * @param bm: Pointer to the bitmap
  * @return: Index of first zero bit, or -1 if all bits are set
  */
-int find_first_zero_bit(void)
+int bitmap_find_first_zero_bit(Bitmap *bm)
 {
-    // TODO: Loop through all bits and find the first one that is 0
-    // Use test_bit() function to check each bit
+    if (bm == NULL)
+    {
+        return -1;
+    }
 
-    // loop through the bits to find the first zero
-    for (int i = 0; i < current_bitmap_size; i++)
+    // skip full words, then locate the lowest zero with ctz of the inverse
+    for (int i = 0; i < bm->nwords; i++)
     {
-        if (test_bit(i) == 0)
+        uint64_t free_bits = ~bm->words[i];
+        if (free_bits != 0)
         {
-            return i;
+            int n = i * BITMAP_WORD_BITS + WORD_CTZ(free_bits);
+            // the zero may be one of the padding bits past nbits
+            return n < bm->nbits ? n : -1;
         }
     }
     return -1;
@@ -139,64 +219,83 @@ int find_first_zero_bit(void)
 //------------------------------------------------------------------//
 
 /**
- * find_next_set_bit - Find next set bit after position start
+ * bitmap_find_next_set_bit - Find next set bit after position start
+ * @param bm: Pointer to the bitmap
  * @param start: Starting position to search from
  * @return: Index of next set bit, or -1 if none found
  */
-int find_next_set_bit(int start)
+int bitmap_find_next_set_bit(Bitmap *bm, int start)
 {
-    // TODO: Loop from (start+1) to bitmap_size and find first set bit
-    // Use test_bit() function to check each
+    if (bm == NULL || bm->nbits == 0)
+    {
+        return -1;
+    }
+
+    // checked before start + 1 so that INT_MAX cannot overflow
+    if (start >= bm->nbits - 1)
+    {
+        return -1;
+    }
+    int n = start < 0 ? 0 : start + 1;
 
-    // loop through to find the first set bit = 1
-    for (int i = start + 1; i < current_bitmap_size; i++)
+    // mask off bits below n in the first word, then scan whole words
+    int i = WORD_INDEX(n);
+    uint64_t word = bm->words[i] & (~0ULL << WORD_OFFSET(n));
+    while (word == 0)
     {
-        if (test_bit(i) == 1)
+        if (++i >= bm->nwords)
         {
-            return i;
+            return -1;
         }
+        word = bm->words[i];
     }
-    // nothing found
-    return -1;
+    return i * BITMAP_WORD_BITS + WORD_CTZ(word);
 }
 
 //------------------------------------------------------------------//
 
 /**
- * print_bitmap - Print bitmap in binary format (MSB to LSB in each byte)
- * Format: Print only the bits, space between bytes, no newlines
+ * bitmap_count_set_bits - Count the number of set bits
+ * @param bm: Pointer to the bitmap
+ * @return: Number of bits set to 1
  */
-void print_bitmap(void)
+int bitmap_count_set_bits(Bitmap *bm)
 {
-    // TODO: Loop through bytes and bits to print binary representation
-    // Print from MSB to LSB in each byte: bit 7, 6, 5, 4, 3, 2, 1, 0
-    // Add space between bytes, only print bits within bitmap size
+    if (bm == NULL)
+    {
+        return 0;
+    }
+    // whole-bitmap popcount goes through the SIMD range kernel
+    return bitmap_count_range(bm, 0, bm->nbits);
+}
+
+//------------------------------------------------------------------//
 
-    // empty case
-    if (current_bitmap_size == 0)
+/**
+ * bitmap_print - Print bitmap in binary format (MSB to LSB in each byte)
+ * @param bm: Pointer to the bitmap
+ * Format: Print only the bits, space between bytes, no newlines
+ */
+void bitmap_print(Bitmap *bm)
+{
+    if (bm == NULL || bm->nbits == 0)
     {
         return;
     }
 
-    int bytesNeeded = (current_bitmap_size + 7) / 8;
+    int bytesNeeded = (bm->nbits + 7) / 8;
 
     // print 8 bits at a time = 1 byte and add spaces
     for (int bytePosition = bytesNeeded - 1; bytePosition >= 0; bytePosition--)
     {
-
-        // print 8 bits
         for (int bitPosition = 7; bitPosition >= 0; bitPosition--)
         {
-            // calculate the bits index in the bitmap
             int bitmapPosition = bytePosition * 8 + bitPosition;
-
-            // prints if it exists in the map
-            if (bitmapPosition < current_bitmap_size)
+            if (bitmapPosition < bm->nbits)
             {
-                printf("%d", (bitmap_data[bytePosition] >> bitPosition) & 1);
+                printf("%d", bitmap_test_bit(bm, bitmapPosition));
             }
         }
-        // spaces between
         if (bytePosition > 0)
         {
             printf(" ");
@@ -207,42 +306,157 @@ void print_bitmap(void)
 //------------------------------------------------------------------//
 
 /**
- * is_bitmap_empty - Check if all bits are 0
+ * bitmap_is_empty - Check if all bits are 0
+ * @param bm: Pointer to the bitmap
  * @return: 1 if all bits are 0, 0 if any bit is set
  */
-int is_bitmap_empty(void)
+int bitmap_is_empty(Bitmap *bm)
 {
-    // TODO: Loop through all bits and check if any is set
-    // Use test_bit() or check bytes directly
-
-    // empty case
-    if (current_bitmap_size == 0)
+    if (bm == NULL)
     {
         return 1;
     }
 
-    // loop through each bit to check if any are set = 1
-    for (int i = 0; i < current_bitmap_size; i++)
+    // padding bits are always 0, so whole words can be compared
+    for (int i = 0; i < bm->nwords; i++)
     {
-        if (test_bit(i) == 1)
+        if (bm->words[i] != 0)
         {
             return 0;
         }
     }
-    // all zeros = empty
     return 1;
 }
 
 //------------------------------------------------------------------//
 
+/**
+ * bitmap_num_bits - Get the number of valid bits
+ * @param bm: Pointer to the bitmap
+ * @return: Number of bits in the bitmap
+ */
+int bitmap_num_bits(Bitmap *bm)
+{
+    return bm == NULL ? 0 : bm->nbits;
+}
+
+/******************************************************************
+    ⚠️PROVIDED IMPLEMENTATION -Students dont implement this!
+******************************************************************/
+/**
+ * init_bitmap - Initialize bitmap with specified size
+ * @param size: Number of bits in the bitmap (must be > 0)
+ *
+ * PROVIDED IMPLEMENTATION - No need to implement this function
+ * This function is provided to help students focus on core bit manipulation concepts
+ */
+void init_bitmap(int size)
+{
+    // check size bounds, an invalid size keeps the current bitmap
+    if (size <= 0)
+    {
+        return;
+    }
+
+    // reuse the default instance's storage and clear it
+    if (bitmap_resize(&default_bitmap, size) == 0)
+    {
+        memset(default_bitmap.words, 0, (size_t)default_bitmap.nwords * sizeof(uint64_t));
+    }
+}
+
+/******************************************************************
+  👍STUDENT IMPLEMENTATION -Students implement these 8 functions
+******************************************************************/
+
+//------------------------------------------------------------------//
+
+/**
+ * set_bit - Set bit n to 1
+ * @param n: Bit index to set (0-based)
+ */
+void set_bit(int n)
+{
+    bitmap_set_bit(&default_bitmap, n);
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * clear_bit - Clear bit n to 0
+ * @param n: Bit index to clear (0-based)
+ */
+void clear_bit(int n)
+{
+    bitmap_clear_bit(&default_bitmap, n);
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * test_bit - Test if bit n is set
+ * @param n: Bit index to test (0-based)
+ * @return: 1 if set, 0 if clear, -1 if invalid index
+ */
+int test_bit(int n)
+{
+    return bitmap_test_bit(&default_bitmap, n);
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * find_first_zero_bit - Find first unset bit
+ * @return: Index of first zero bit, or -1 if all bits are set
+ */
+int find_first_zero_bit(void)
+{
+    return bitmap_find_first_zero_bit(&default_bitmap);
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * find_next_set_bit - Find next set bit after position start
+ * @param start: Starting position to search from
+ * @return: Index of next set bit, or -1 if none found
+ */
+int find_next_set_bit(int start)
+{
+    return bitmap_find_next_set_bit(&default_bitmap, start);
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * print_bitmap - Print bitmap in binary format (MSB to LSB in each byte)
+ * Format: Print only the bits, space between bytes, no newlines
+ */
+void print_bitmap(void)
+{
+    bitmap_print(&default_bitmap);
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * is_bitmap_empty - Check if all bits are 0
+ * @return: 1 if all bits are 0, 0 if any bit is set
+ */
+int is_bitmap_empty(void)
+{
+    return bitmap_is_empty(&default_bitmap);
+}
+
+//------------------------------------------------------------------//
+
 /**
  * bitmap_size - Get current bitmap size
  * @return: Number of bits in the current bitmap
  */
 int bitmap_size(void)
 {
-    // TODO: Return the current_bitmap_size
-    return current_bitmap_size;
+    return bitmap_num_bits(&default_bitmap);
 }
 
 //------------------------------------------------------------------//
\ No newline at end of file
@@ -0,0 +1,470 @@
+// Bitmap range operations - bulk set/clear, popcount and run finder
+// See ds_header.h for structure and prototype definitions
+// Used in: frame allocators that grab or release N contiguous pages
+
+#include "ds_header.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BITMAP_X86 1
+#include <immintrin.h>
+#endif
+
+// Word helpers - bit n lives in word n / 64 at position n % 64
+#define WORD_INDEX(n) ((n) / BITMAP_WORD_BITS)
+#define WORD_OFFSET(n) ((n) % BITMAP_WORD_BITS)
+#define WORD_CTZ(w) __builtin_ctzll(w)
+#define WORD_CLZ(w) __builtin_clzll(w)
+#define WORD_POPCOUNT(w) __builtin_popcountll(w)
+
+// Kernel level in use, -1 until the CPU has been probed
+static int simd_level = -1;
+
+/******************************************************************
+  SCAN KERNELS - scalar fallback plus SSE2 / AVX2 versions
+******************************************************************/
+
+//------------------------------------------------------------------//
+
+/**
+ * skip_words_scalar - Skip words equal to value
+ * @param words: Word array
+ * @param i: First word to look at
+ * @param n: One past the last word to look at
+ * @param value: Word value to skip over (0 or all ones)
+ * @return: Index of the first word in [i, n) not equal to value, or n
+ */
+static int skip_words_scalar(const uint64_t *words, int i, int n, uint64_t value)
+{
+    while (i < n && words[i] == value)
+    {
+        i++;
+    }
+    return i;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * popcount_words_scalar - Count set bits in words [i, n)
+ */
+static long long popcount_words_scalar(const uint64_t *words, int i, int n)
+{
+    long long count = 0;
+    for (; i < n; i++)
+    {
+        count += WORD_POPCOUNT(words[i]);
+    }
+    return count;
+}
+
+#if defined(BITMAP_X86) && defined(__SSE2__)
+
+//------------------------------------------------------------------//
+
+/**
+ * skip_words_sse2 - Skip words equal to value, two words per compare
+ */
+static int skip_words_sse2(const uint64_t *words, int i, int n, uint64_t value)
+{
+    // 32-bit lane compare is enough since both halves of value are equal
+    __m128i target = _mm_set1_epi32((int)(uint32_t)value);
+    for (; i + 2 <= n; i += 2)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(words + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(v, target)) != 0xFFFF)
+        {
+            break;
+        }
+    }
+    return skip_words_scalar(words, i, n, value);
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * popcount_words_sse2 - Count set bits in words [i, n) with SWAR per byte
+ */
+static long long popcount_words_sse2(const uint64_t *words, int i, int n)
+{
+    const __m128i m1 = _mm_set1_epi8(0x55);
+    const __m128i m2 = _mm_set1_epi8(0x33);
+    const __m128i m4 = _mm_set1_epi8(0x0F);
+    __m128i acc = _mm_setzero_si128();
+
+    for (; i + 2 <= n; i += 2)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(words + i));
+        v = _mm_sub_epi8(v, _mm_and_si128(_mm_srli_epi64(v, 1), m1));
+        v = _mm_add_epi8(_mm_and_si128(v, m2), _mm_and_si128(_mm_srli_epi64(v, 2), m2));
+        v = _mm_and_si128(_mm_add_epi8(v, _mm_srli_epi64(v, 4)), m4);
+        // sum the byte counts of each 64-bit half
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(v, _mm_setzero_si128()));
+    }
+
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i *)lanes, acc);
+    return (long long)(lanes[0] + lanes[1]) + popcount_words_scalar(words, i, n);
+}
+
+#endif
+
+#if defined(BITMAP_X86)
+
+//------------------------------------------------------------------//
+
+/**
+ * skip_words_avx2 - Skip words equal to value, four words per compare
+ */
+__attribute__((target("avx2"))) static int skip_words_avx2(const uint64_t *words, int i, int n, uint64_t value)
+{
+    __m256i target = _mm256_set1_epi64x((long long)value);
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(words + i));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi64(v, target)) != -1)
+        {
+            break;
+        }
+    }
+    return skip_words_scalar(words, i, n, value);
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * popcount_words_avx2 - Count set bits in words [i, n) with a nibble lookup
+ */
+__attribute__((target("avx2"))) static long long popcount_words_avx2(const uint64_t *words, int i, int n)
+{
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+    __m256i acc = _mm256_setzero_si256();
+
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(words + i));
+        __m256i lo = _mm256_and_si256(v, low_mask);
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+        __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+    }
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i *)lanes, acc);
+    return (long long)(lanes[0] + lanes[1] + lanes[2] + lanes[3]) + popcount_words_scalar(words, i, n);
+}
+
+#endif
+
+//------------------------------------------------------------------//
+
+/**
+ * bitmap_simd_select - Choose which kernel the range operations use
+ * @param level: BITMAP_SIMD_SCALAR, BITMAP_SIMD_SSE2 or BITMAP_SIMD_AVX2
+ * @return: Level actually in use (lowered to what the CPU supports)
+ */
+int bitmap_simd_select(int level)
+{
+    int best = BITMAP_SIMD_SCALAR;
+#if defined(BITMAP_X86)
+#if defined(__SSE2__)
+    best = BITMAP_SIMD_SSE2;
+#endif
+    if (__builtin_cpu_supports("avx2"))
+    {
+        best = BITMAP_SIMD_AVX2;
+    }
+#endif
+
+    if (level < BITMAP_SIMD_SCALAR)
+    {
+        level = BITMAP_SIMD_SCALAR;
+    }
+    simd_level = level < best ? level : best;
+    return simd_level;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * skip_words - Dispatch to the selected skip kernel
+ */
+static int skip_words(const uint64_t *words, int i, int n, uint64_t value)
+{
+    if (simd_level < 0)
+    {
+        bitmap_simd_select(BITMAP_SIMD_AVX2);
+    }
+#if defined(BITMAP_X86)
+    if (simd_level == BITMAP_SIMD_AVX2)
+    {
+        return skip_words_avx2(words, i, n, value);
+    }
+#if defined(__SSE2__)
+    if (simd_level == BITMAP_SIMD_SSE2)
+    {
+        return skip_words_sse2(words, i, n, value);
+    }
+#endif
+#endif
+    return skip_words_scalar(words, i, n, value);
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * popcount_words - Dispatch to the selected popcount kernel
+ */
+static long long popcount_words(const uint64_t *words, int i, int n)
+{
+    if (simd_level < 0)
+    {
+        bitmap_simd_select(BITMAP_SIMD_AVX2);
+    }
+#if defined(BITMAP_X86)
+    if (simd_level == BITMAP_SIMD_AVX2)
+    {
+        return popcount_words_avx2(words, i, n);
+    }
+#if defined(__SSE2__)
+    if (simd_level == BITMAP_SIMD_SSE2)
+    {
+        return popcount_words_sse2(words, i, n);
+    }
+#endif
+#endif
+    return popcount_words_scalar(words, i, n);
+}
+
+/******************************************************************
+  RANGE OPERATIONS
+******************************************************************/
+
+//------------------------------------------------------------------//
+
+/**
+ * range_mask - Mask of bits [lo, hi) within a single word
+ * @param lo: First bit (0..63)
+ * @param hi: One past the last bit (1..64)
+ */
+static uint64_t range_mask(int lo, int hi)
+{
+    uint64_t upper = hi == BITMAP_WORD_BITS ? ~0ULL : (1ULL << hi) - 1;
+    return upper & (~0ULL << lo);
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * fill_range - Set or clear bits [start, end)
+ * @param bm: Pointer to the bitmap
+ * @param start: First bit of the range
+ * @param end: One past the last bit of the range
+ * @param set: 1 to set the bits, 0 to clear them
+ * @return: 0 on success, -1 on invalid range
+ */
+static int fill_range(Bitmap *bm, int start, int end, int set)
+{
+    if (bm == NULL || start < 0 || end > bm->nbits || start > end)
+    {
+        return -1;
+    }
+    if (start == end)
+    {
+        return 0;
+    }
+
+    int first = WORD_INDEX(start);
+    int last = WORD_INDEX(end - 1);
+
+    // range inside a single word
+    if (first == last)
+    {
+        uint64_t mask = range_mask(WORD_OFFSET(start), WORD_OFFSET(end - 1) + 1);
+        bm->words[first] = set ? bm->words[first] | mask : bm->words[first] & ~mask;
+        return 0;
+    }
+
+    // partial head and tail words, whole words in between
+    uint64_t head = range_mask(WORD_OFFSET(start), BITMAP_WORD_BITS);
+    uint64_t tail = range_mask(0, WORD_OFFSET(end - 1) + 1);
+    bm->words[first] = set ? bm->words[first] | head : bm->words[first] & ~head;
+    bm->words[last] = set ? bm->words[last] | tail : bm->words[last] & ~tail;
+
+    // memset is already vectorized by libc for the bulk fill
+    if (last - first > 1)
+    {
+        memset(bm->words + first + 1, set ? 0xFF : 0x00, (size_t)(last - first - 1) * sizeof(uint64_t));
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * bitmap_set_range - Set bits [start, end) to 1
+ * @param bm: Pointer to the bitmap
+ * @param start: First bit of the range
+ * @param end: One past the last bit of the range
+ * @return: 0 on success, -1 on invalid range
+ */
+int bitmap_set_range(Bitmap *bm, int start, int end)
+{
+    return fill_range(bm, start, end, 1);
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * bitmap_clear_range - Clear bits [start, end) to 0
+ * @param bm: Pointer to the bitmap
+ * @param start: First bit of the range
+ * @param end: One past the last bit of the range
+ * @return: 0 on success, -1 on invalid range
+ */
+int bitmap_clear_range(Bitmap *bm, int start, int end)
+{
+    return fill_range(bm, start, end, 0);
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * bitmap_count_range - Count set bits in [start, end)
+ * @param bm: Pointer to the bitmap
+ * @param start: First bit of the range
+ * @param end: One past the last bit of the range
+ * @return: Number of set bits, or -1 on invalid range
+ */
+int bitmap_count_range(Bitmap *bm, int start, int end)
+{
+    if (bm == NULL || start < 0 || end > bm->nbits || start > end)
+    {
+        return -1;
+    }
+    if (start == end)
+    {
+        return 0;
+    }
+
+    int first = WORD_INDEX(start);
+    int last = WORD_INDEX(end - 1);
+
+    if (first == last)
+    {
+        uint64_t mask = range_mask(WORD_OFFSET(start), WORD_OFFSET(end - 1) + 1);
+        return WORD_POPCOUNT(bm->words[first] & mask);
+    }
+
+    long long count = WORD_POPCOUNT(bm->words[first] & range_mask(WORD_OFFSET(start), BITMAP_WORD_BITS));
+    count += WORD_POPCOUNT(bm->words[last] & range_mask(0, WORD_OFFSET(end - 1) + 1));
+    count += popcount_words(bm->words, first + 1, last);
+    return (int)count;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * word_zero_run - Find a run of count zero bits inside one word
+ * @param word: Word to search
+ * @param count: Run length (1..63)
+ * @return: Lowest bit position where the run starts, or -1
+ */
+static int word_zero_run(uint64_t word, int count)
+{
+    // bit p of runs survives only if bits p .. p+len-1 are all zero,
+    // doubling len each step so this takes log2(count) shifts
+    uint64_t runs = ~word;
+    int len = 1;
+    while (len < count && runs != 0)
+    {
+        int shift = len < count - len ? len : count - len;
+        runs &= runs >> shift;
+        len += shift;
+    }
+    return runs != 0 ? WORD_CTZ(runs) : -1;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * bitmap_find_zero_run - Find the first run of count contiguous zero bits
+ * @param bm: Pointer to the bitmap
+ * @param count: Number of contiguous zero bits wanted (> 0)
+ * @return: Index of the first bit of the run, or -1 if none exists
+ */
+int bitmap_find_zero_run(Bitmap *bm, int count)
+{
+    if (bm == NULL || count <= 0 || count > bm->nbits)
+    {
+        return -1;
+    }
+
+    // the last word is handled on its own so padding can be marked used
+    int last = bm->nwords - 1;
+    long long run_len = 0;
+    int run_start = 0;
+
+    for (int i = 0; i <= last; i++)
+    {
+        uint64_t word = bm->words[i];
+        if (i == last)
+        {
+            word |= ~BITMAP_TAIL_MASK(bm->nbits);
+        }
+
+        if (word == 0)
+        {
+            // free word extends (or starts) the current run, then skip
+            // the following free words in bulk
+            if (run_len == 0)
+            {
+                run_start = i * BITMAP_WORD_BITS;
+            }
+            int next = skip_words(bm->words, i + 1, last, 0);
+            run_len += (long long)(next - i) * BITMAP_WORD_BITS;
+            if (run_len >= count)
+            {
+                return run_start;
+            }
+            i = next - 1;
+            continue;
+        }
+
+        if (word == ~0ULL)
+        {
+            // full word breaks the run, skip the following full words
+            run_len = 0;
+            i = skip_words(bm->words, i + 1, last, ~0ULL) - 1;
+            continue;
+        }
+
+        // low zero bits extend the current run
+        if (run_len == 0)
+        {
+            run_start = i * BITMAP_WORD_BITS;
+        }
+        if (run_len + WORD_CTZ(word) >= count)
+        {
+            return run_start;
+        }
+
+        // a short run may fit entirely inside this word
+        if (count < BITMAP_WORD_BITS)
+        {
+            int pos = word_zero_run(word, count);
+            if (pos >= 0)
+            {
+                return i * BITMAP_WORD_BITS + pos;
+            }
+        }
+
+        // high zero bits start a new run
+        run_len = WORD_CLZ(word);
+        run_start = (i + 1) * BITMAP_WORD_BITS - (int)run_len;
+    }
+    return -1;
+}
+
+//------------------------------------------------------------------//
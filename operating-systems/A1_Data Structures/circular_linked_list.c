@@ -3,6 +3,26 @@
 
 #include "ds_header.h"
 
+// Nodes come from a slab pool so inserts and deletes do not hit malloc;
+// once no node is in use the slabs are returned to the system
+static NodePool list_pool = {NULL, NULL, NODE_POOL_DEFAULT_SLAB, 0};
+static long list_live_nodes = 0;
+
+/**
+ * release_list_node - Give a node back to the pool, and the pool's slabs
+ * back to the system when it was the last node in use
+ * @param node: Node to release, must not be used afterwards
+ */
+static void release_list_node(Node *node)
+{
+    if (--list_live_nodes == 0)
+    {
+        node_pool_destroy(&list_pool);
+        return;
+    }
+    node_pool_release(&list_pool, node);
+}
+
 /******************************************************************
   👍STUDENT IMPLEMENTATION -Students implement these 7 functions
 ******************************************************************/
@@ -16,14 +36,15 @@
 Node *create_node(int data)
 {
     // TODO: Allocate and initialize node
-    // allocate space
-    Node *node = (Node *)malloc(sizeof(Node));
+    // take a node from the pool (recycled or carved from a slab)
+    Node *node = node_pool_alloc(&list_pool);
 
     //
     if (node == NULL)
     {
         exit(1);
     }
+    list_live_nodes++;
     // set data
     node->data = data;
     node->next = NULL; // updated later
@@ -98,7 +119,7 @@ Node *delete_node(Node *head, int key)
     {
         if (head->data == key)
         {
-            free(head);
+            release_list_node(head);
             return NULL;
         }
         return head;
@@ -116,7 +137,7 @@ Node *delete_node(Node *head, int key)
         // update the last node to point to new head
         last->next = head->next;
         Node *new_head = head->next;
-        free(head);
+        release_list_node(head);
         return new_head;
     }
 
@@ -128,7 +149,7 @@ Node *delete_node(Node *head, int key)
         if (current->data == key)
         {
             prev->next = current->next;
-            free(current);
+            release_list_node(current);
             return head;
         }
         prev = current;
@@ -198,6 +219,10 @@ int iterate_list(Node *head)
 
 /**
  * free_list - Frees all nodes in a circular linked list
+ *
+ * Nodes go back to the pool free list for the next create_node; when
+ * they were the last nodes in use, every slab is freed in one pass
+ * instead.
  * @param head: Head of list
  * @return: -1 if list is already empty, 0 if memory was successfully freed
  */
@@ -211,7 +236,7 @@ int free_list(Node *head)
     // only head node
     if (head->next == head)
     {
-        free(head);
+        release_list_node(head);
         return 0;
     }
 
@@ -227,11 +252,24 @@ int free_list(Node *head)
     }
     last->next = NULL; // setting the last->next to null breaks it
 
-    // iterate through and free
+    // count the nodes; if no other list holds any, drop the slabs at once
+    long count = 0;
+    for (Node *node = head; node != NULL; node = node->next)
+    {
+        count++;
+    }
+    if (count == list_live_nodes)
+    {
+        node_pool_destroy(&list_pool);
+        list_live_nodes = 0;
+        return 0;
+    }
+
+    // iterate through and hand every node back to the pool
     while (current != NULL)
     {
         next_node = current->next;
-        free(current);
+        release_list_node(current);
         current = next_node;
     }
 
@@ -0,0 +1,347 @@
+// Circular List - tail pointer for O(1) append, optional hashed key index
+// See ds_header.h for structure and prototype definitions
+
+#include "ds_header.h"
+
+#define INDEX_MIN_SLOTS 16
+
+// Marks a slot whose entry was deleted, so probe chains stay intact
+static Node deleted_slot;
+#define SLOT_DELETED (&deleted_slot)
+
+//------------------------------------------------------------------//
+
+/**
+ * index_hash - Starting slot for a key (Fibonacci hashing)
+ */
+static int index_hash(CircularList *list, int key)
+{
+    uint32_t h = (uint32_t)key * 2654435769u;
+    return (int)((h ^ (h >> 16)) & (uint32_t)list->index_mask);
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * index_put - Add an entry, the table must have room (see index_reserve)
+ */
+static void index_put(CircularList *list, Node *prev, int key)
+{
+    int i = index_hash(list, key);
+    while (list->slots[i].prev != NULL && list->slots[i].prev != SLOT_DELETED)
+    {
+        i = (i + 1) & list->index_mask;
+    }
+    if (list->slots[i].prev == NULL)
+    {
+        list->index_used++;
+    }
+    list->slots[i].prev = prev;
+    list->slots[i].key = key;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * index_find - Find the slot of a key
+ * @param prev: Predecessor to match as well, or NULL to accept any node with key
+ * @return: Slot index, -1 if not found
+ */
+static int index_find(CircularList *list, int key, Node *prev)
+{
+    int i = index_hash(list, key);
+    while (list->slots[i].prev != NULL)
+    {
+        ListIndexEntry *entry = &list->slots[i];
+        if (entry->prev != SLOT_DELETED && entry->key == key && (prev == NULL || entry->prev == prev))
+        {
+            return i;
+        }
+        i = (i + 1) & list->index_mask;
+    }
+    return -1;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * index_reserve - Make room for one more entry before the ring changes
+ * @return: 0 on success, -1 on allocation failure (index left as it was)
+ *
+ * Keeps the load (live plus deleted slots) under 3/4. The table is rebuilt
+ * from the ring itself, which also drops every deleted slot.
+ */
+static int index_reserve(CircularList *list)
+{
+    if ((list->index_used + 1) * 4 <= (list->index_mask + 1) * 3)
+    {
+        return 0;
+    }
+
+    int capacity = ds_next_pow2(list->size * 2 + 2);
+    if (capacity < 0)
+    {
+        return -1;
+    }
+    if (capacity < INDEX_MIN_SLOTS)
+    {
+        capacity = INDEX_MIN_SLOTS;
+    }
+    ListIndexEntry *slots = (ListIndexEntry *)calloc((size_t)capacity, sizeof(ListIndexEntry));
+    if (slots == NULL)
+    {
+        return -1;
+    }
+
+    free(list->slots);
+    list->slots = slots;
+    list->index_mask = capacity - 1;
+    list->index_used = 0;
+    if (list->head != NULL)
+    {
+        Node *prev = list->tail;
+        do
+        {
+            index_put(list, prev, prev->next->data);
+            prev = prev->next;
+        } while (prev != list->tail);
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * list_init - Initialize an empty list
+ * @param list: Pointer to the list to initialize
+ * @param indexed: Non-zero to keep a key index for O(1) search and delete
+ * @return: 0 on success, -1 on allocation failure
+ */
+int list_init(CircularList *list, int indexed)
+{
+    if (list == NULL)
+    {
+        return -1;
+    }
+
+    list->head = NULL;
+    list->tail = NULL;
+    list->size = 0;
+    node_pool_init(&list->pool, 0);
+    list->slots = NULL;
+    list->index_mask = 0;
+    list->index_used = 0;
+    if (indexed)
+    {
+        list->slots = (ListIndexEntry *)calloc(INDEX_MIN_SLOTS, sizeof(ListIndexEntry));
+        if (list->slots == NULL)
+        {
+            return -1;
+        }
+        list->index_mask = INDEX_MIN_SLOTS - 1;
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * list_free - Release every node and the index
+ * @param list: Pointer to the list
+ *
+ * Frees the node pool slab by slab instead of walking the ring.
+ * Call list_init again before reusing the list.
+ */
+void list_free(CircularList *list)
+{
+    if (list == NULL)
+    {
+        return;
+    }
+    node_pool_destroy(&list->pool);
+    free(list->slots);
+    list->slots = NULL;
+    list->index_mask = 0;
+    list->index_used = 0;
+    list->head = NULL;
+    list->tail = NULL;
+    list->size = 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * list_append - Insert a new node after the tail
+ * @param list: Pointer to the list
+ * @param data: Value to store
+ * @return: 0 on success, -1 if out of memory
+ */
+int list_append(CircularList *list, int data)
+{
+    if (list == NULL || list->size == INT_MAX)
+    {
+        return -1;
+    }
+    if (list->slots != NULL && index_reserve(list) != 0)
+    {
+        return -1;
+    }
+    Node *node = node_pool_alloc(&list->pool);
+    if (node == NULL)
+    {
+        return -1;
+    }
+    node->data = data;
+
+    if (list->head == NULL)
+    {
+        node->next = node;
+        list->head = node;
+        list->tail = node;
+        if (list->slots != NULL)
+        {
+            index_put(list, node, data);
+        }
+        list->size = 1;
+        return 0;
+    }
+
+    Node *old_tail = list->tail;
+    if (list->slots != NULL)
+    {
+        // the head's predecessor moves from the old tail to the new node;
+        // update it before adding another entry with prev == old_tail
+        list->slots[index_find(list, list->head->data, old_tail)].prev = node;
+        index_put(list, old_tail, data);
+    }
+    node->next = list->head;
+    old_tail->next = node;
+    list->tail = node;
+    list->size++;
+    return 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * list_search - Find a node by key
+ * @param list: Pointer to the list
+ * @param key: Data value to find
+ * @return: Matching node, NULL if not found or the list is empty
+ */
+Node *list_search(CircularList *list, int key)
+{
+    if (list == NULL || list->head == NULL)
+    {
+        return NULL;
+    }
+
+    if (list->slots != NULL)
+    {
+        int i = index_find(list, key, NULL);
+        return i < 0 ? NULL : list->slots[i].prev->next;
+    }
+
+    Node *current = list->head;
+    do
+    {
+        if (current->data == key)
+        {
+            return current;
+        }
+        current = current->next;
+    } while (current != list->head);
+    return NULL;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * list_delete - Remove a node by key
+ * @param list: Pointer to the list
+ * @param key: Data value to remove
+ * @return: 0 if a node was removed, -1 if key was not found
+ */
+int list_delete(CircularList *list, int key)
+{
+    if (list == NULL || list->head == NULL)
+    {
+        return -1;
+    }
+
+    Node *prev = NULL;
+    int slot = -1;
+    if (list->slots != NULL)
+    {
+        slot = index_find(list, key, NULL);
+        if (slot < 0)
+        {
+            return -1;
+        }
+        prev = list->slots[slot].prev;
+    }
+    else
+    {
+        // walk with the predecessor, starting from the tail
+        Node *current = list->tail;
+        do
+        {
+            if (current->next->data == key)
+            {
+                prev = current;
+                break;
+            }
+            current = current->next;
+        } while (current != list->tail);
+        if (prev == NULL)
+        {
+            return -1;
+        }
+    }
+
+    Node *victim = prev->next;
+    if (list->size == 1)
+    {
+        list->head = NULL;
+        list->tail = NULL;
+    }
+    else
+    {
+        Node *succ = victim->next;
+        if (list->slots != NULL)
+        {
+            list->slots[index_find(list, succ->data, victim)].prev = prev;
+        }
+        prev->next = succ;
+        if (victim == list->head)
+        {
+            list->head = succ;
+        }
+        if (victim == list->tail)
+        {
+            list->tail = prev;
+        }
+    }
+
+    if (slot >= 0)
+    {
+        list->slots[slot].prev = SLOT_DELETED;
+    }
+    node_pool_release(&list->pool, victim);
+    list->size--;
+    return 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * list_size - Return the number of nodes
+ * @param list: Pointer to the list
+ * @return: Number of nodes
+ */
+int list_size(CircularList *list)
+{
+    return list == NULL ? 0 : list->size;
+}
+
+//------------------------------------------------------------------//
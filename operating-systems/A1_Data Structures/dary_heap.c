@@ -0,0 +1,167 @@
+// 4-ary Min-Heap - hole-based sifting, no MAX_SIZE limit
+// See ds_header.h for structure and prototype definitions
+#include "ds_header.h"
+
+// Heap navigation for DARY_D children per node
+#define DARY_CHILD(i) (DARY_D * (i) + 1)
+#define DARY_PARENT(i) (((i) - 1) / DARY_D)
+
+//------------------------------------------------------------------//
+
+/**
+ * dheap_init - Initialize an empty 4-ary heap
+ * @param heap: Pointer to the heap to initialize
+ * @param capacity: Initial number of slots (grows as needed)
+ * @return: 0 on success, -1 on allocation failure
+ */
+int dheap_init(DaryHeap *heap, int capacity)
+{
+    if (heap == NULL)
+    {
+        return -1;
+    }
+    heap->capacity = capacity > 0 ? capacity : 16;
+    heap->data = (HeapNode *)malloc((size_t)heap->capacity * sizeof(HeapNode));
+    heap->size = 0;
+    return heap->data == NULL ? -1 : 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * dheap_free - Release the heap storage
+ * @param heap: Pointer to the heap
+ */
+void dheap_free(DaryHeap *heap)
+{
+    if (heap == NULL)
+    {
+        return;
+    }
+    free(heap->data);
+    heap->data = NULL;
+    heap->size = 0;
+    heap->capacity = 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * dheap_insert - Insert a new element
+ * @param heap: Pointer to the heap
+ * @param element: The HeapNode to insert
+ * @return: 0 on success, -1 if the heap could not grow
+ */
+int dheap_insert(DaryHeap *heap, HeapNode element)
+{
+    if (heap == NULL)
+    {
+        return -1;
+    }
+    if (heap->size == heap->capacity)
+    {
+        if (heap->capacity > INT_MAX / 2)
+        {
+            return -1;
+        }
+        HeapNode *data = (HeapNode *)realloc(heap->data, (size_t)heap->capacity * 2 * sizeof(HeapNode));
+        if (data == NULL)
+        {
+            return -1;
+        }
+        heap->data = data;
+        heap->capacity *= 2;
+    }
+
+    // move parents down into the hole, write the element once at the end
+    int hole = heap->size++;
+    while (hole > 0 && heap->data[DARY_PARENT(hole)].priority > element.priority)
+    {
+        heap->data[hole] = heap->data[DARY_PARENT(hole)];
+        hole = DARY_PARENT(hole);
+    }
+    heap->data[hole] = element;
+    return 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * dheap_extract_min - Remove and return the element with minimum priority
+ * @param heap: Pointer to the heap
+ * @return: Minimum element, or {-1, INT_MAX} if the heap is empty
+ */
+HeapNode dheap_extract_min(DaryHeap *heap)
+{
+    HeapNode dummy = {-1, INT_MAX};
+    if (heap == NULL || heap->size == 0)
+    {
+        return dummy;
+    }
+
+    HeapNode min = heap->data[0];
+    HeapNode last = heap->data[--heap->size];
+    if (heap->size == 0)
+    {
+        return min;
+    }
+
+    // sift the hole at the root down, pulling up the smallest child
+    int hole = 0;
+    for (;;)
+    {
+        int first = DARY_CHILD(hole);
+        if (first >= heap->size)
+        {
+            break;
+        }
+        int end = first + DARY_D < heap->size ? first + DARY_D : heap->size;
+        int smallest = first;
+        for (int c = first + 1; c < end; c++)
+        {
+            if (heap->data[c].priority < heap->data[smallest].priority)
+            {
+                smallest = c;
+            }
+        }
+        if (heap->data[smallest].priority >= last.priority)
+        {
+            break;
+        }
+        heap->data[hole] = heap->data[smallest];
+        hole = smallest;
+    }
+    heap->data[hole] = last;
+    return min;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * dheap_peek - Return the element with minimum priority without removing it
+ * @param heap: Pointer to the heap
+ * @return: Minimum element, or {-1, INT_MAX} if the heap is empty
+ */
+HeapNode dheap_peek(DaryHeap *heap)
+{
+    HeapNode dummy = {-1, INT_MAX};
+    if (heap == NULL || heap->size == 0)
+    {
+        return dummy;
+    }
+    return heap->data[0];
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * dheap_size - Return the number of elements in the heap
+ * @param heap: Pointer to the heap
+ * @return: Number of elements
+ */
+int dheap_size(DaryHeap *heap)
+{
+    return heap == NULL ? 0 : heap->size;
+}
+
+//------------------------------------------------------------------//
@@ -0,0 +1,51 @@
+// Shared allocation helpers for the growable and concurrent structures
+// See ds_header.h for prototype definitions
+
+#include "ds_header.h"
+
+//------------------------------------------------------------------//
+
+/**
+ * ds_aligned_alloc - Allocate a zeroed, cache-line aligned block
+ * @param bytes: Requested size in bytes
+ * @return: Pointer to the block (release with free), NULL on failure
+ */
+void *ds_aligned_alloc(size_t bytes)
+{
+    // aligned_alloc needs the size to be a multiple of the alignment
+    size_t rounded = (bytes + DS_CACHE_LINE - 1) / DS_CACHE_LINE * DS_CACHE_LINE;
+    if (rounded == 0)
+    {
+        rounded = DS_CACHE_LINE;
+    }
+
+    void *block = aligned_alloc(DS_CACHE_LINE, rounded);
+    if (block != NULL)
+    {
+        memset(block, 0, rounded);
+    }
+    return block;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * ds_next_pow2 - Round up to the next power of two
+ * @param n: Value to round
+ * @return: Smallest power of two >= n, 1 if n <= 1, -1 if it does not fit in an int
+ */
+int ds_next_pow2(int n)
+{
+    int p = 1;
+    while (p < n)
+    {
+        if (p > INT_MAX / 2)
+        {
+            return -1;
+        }
+        p <<= 1;
+    }
+    return p;
+}
+
+//------------------------------------------------------------------//
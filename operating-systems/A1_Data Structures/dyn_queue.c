@@ -0,0 +1,171 @@
+// Growable Circular Queue (FIFO) - no MAX_SIZE limit
+// See ds_header.h for structure and prototype definitions
+
+#include "ds_header.h"
+
+//------------------------------------------------------------------//
+
+/**
+ * dqueue_grow - Double the capacity of the queue
+ * @param queue: Pointer to the queue
+ * @return: 0 on success, -1 on overflow or allocation failure
+ */
+static int dqueue_grow(DynQueue *queue)
+{
+    unsigned int capacity = queue->mask + 1;
+    if (capacity > (unsigned int)INT_MAX / 2)
+    {
+        return -1;
+    }
+
+    int *data = (int *)ds_aligned_alloc((size_t)capacity * 2 * sizeof(int));
+    if (data == NULL)
+    {
+        return -1;
+    }
+
+    // unwrap the ring: front part up to the end of the buffer, then the
+    // part that wrapped around to the start
+    unsigned int count = queue->tail - queue->head;
+    unsigned int front = queue->head & queue->mask;
+    unsigned int first = capacity - front < count ? capacity - front : count;
+    memcpy(data, queue->data + front, (size_t)first * sizeof(int));
+    memcpy(data + first, queue->data, (size_t)(count - first) * sizeof(int));
+
+    free(queue->data);
+    queue->data = data;
+    queue->head = 0;
+    queue->tail = count;
+    queue->mask = capacity * 2 - 1;
+    return 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * dqueue_init - Initialize a growable circular queue
+ * @param queue: Pointer to the queue structure to initialize
+ * @param capacity: Initial capacity, rounded up to a power of two
+ * @return: 0 on success, -1 on allocation failure
+ */
+int dqueue_init(DynQueue *queue, int capacity)
+{
+    if (queue == NULL)
+    {
+        return -1;
+    }
+
+    int rounded = ds_next_pow2(capacity);
+    if (rounded < 0)
+    {
+        return -1;
+    }
+    queue->data = (int *)ds_aligned_alloc((size_t)rounded * sizeof(int));
+    if (queue->data == NULL)
+    {
+        return -1;
+    }
+    queue->head = 0;
+    queue->tail = 0;
+    queue->mask = (unsigned int)rounded - 1;
+    return 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * dqueue_free - Release the queue buffer
+ * @param queue: Pointer to the queue
+ */
+void dqueue_free(DynQueue *queue)
+{
+    if (queue == NULL)
+    {
+        return;
+    }
+    free(queue->data);
+    queue->data = NULL;
+    queue->head = 0;
+    queue->tail = 0;
+    queue->mask = 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * dqueue_is_empty - Check if the queue is empty
+ * @param queue: Pointer to the queue
+ * @return: 1 if empty, 0 otherwise
+ */
+int dqueue_is_empty(DynQueue *queue)
+{
+    return queue == NULL || queue->head == queue->tail;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * dqueue_enqueue - Add an element to the rear, growing when full
+ * @param queue: Pointer to the queue
+ * @param element: Element to add
+ * @return: 0 on success, -1 if the queue could not grow
+ */
+int dqueue_enqueue(DynQueue *queue, int element)
+{
+    if (queue == NULL || queue->data == NULL)
+    {
+        return -1;
+    }
+    if (queue->tail - queue->head > queue->mask && dqueue_grow(queue) != 0)
+    {
+        return -1;
+    }
+    queue->data[queue->tail++ & queue->mask] = element;
+    return 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * dqueue_dequeue - Remove and return the front element
+ * @param queue: Pointer to the queue
+ * @return: Front element on success, -1 if queue is empty
+ */
+int dqueue_dequeue(DynQueue *queue)
+{
+    if (dqueue_is_empty(queue))
+    {
+        return -1;
+    }
+    return queue->data[queue->head++ & queue->mask];
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * dqueue_peek - Return the front element without removing it
+ * @param queue: Pointer to the queue
+ * @return: Front element if not empty, -1 if queue is empty
+ */
+int dqueue_peek(DynQueue *queue)
+{
+    if (dqueue_is_empty(queue))
+    {
+        return -1;
+    }
+    return queue->data[queue->head & queue->mask];
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * dqueue_size - Return the number of elements in the queue
+ * @param queue: Pointer to the queue
+ * @return: Number of elements in queue
+ */
+int dqueue_size(DynQueue *queue)
+{
+    return queue == NULL ? 0 : (int)(queue->tail - queue->head);
+}
+
+//------------------------------------------------------------------//
@@ -0,0 +1,161 @@
+// Growable Stack (LIFO) - no MAX_SIZE limit
+// See ds_header.h for structure and prototype definitions
+
+#include "ds_header.h"
+
+//------------------------------------------------------------------//
+
+/**
+ * dstack_grow - Double the capacity of the stack
+ * @param stack: Pointer to the stack
+ * @return: 0 on success, -1 on overflow or allocation failure
+ */
+static int dstack_grow(DynStack *stack)
+{
+    if (stack->capacity > INT_MAX / 2)
+    {
+        return -1;
+    }
+
+    int capacity = stack->capacity * 2;
+    int *data = (int *)ds_aligned_alloc((size_t)capacity * sizeof(int));
+    if (data == NULL)
+    {
+        return -1;
+    }
+
+    // realloc would not keep the cache-line alignment, so copy by hand
+    memcpy(data, stack->data, (size_t)stack->top * sizeof(int));
+    free(stack->data);
+    stack->data = data;
+    stack->capacity = capacity;
+    return 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * dstack_init - Initialize a growable stack
+ * @param stack: Pointer to the stack structure to initialize
+ * @param capacity: Initial capacity, rounded up to a power of two
+ * @return: 0 on success, -1 on allocation failure
+ */
+int dstack_init(DynStack *stack, int capacity)
+{
+    if (stack == NULL)
+    {
+        return -1;
+    }
+
+    int rounded = ds_next_pow2(capacity);
+    if (rounded < 0)
+    {
+        return -1;
+    }
+    stack->data = (int *)ds_aligned_alloc((size_t)rounded * sizeof(int));
+    if (stack->data == NULL)
+    {
+        return -1;
+    }
+    stack->top = 0;
+    stack->capacity = rounded;
+    return 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * dstack_free - Release the stack buffer
+ * @param stack: Pointer to the stack
+ */
+void dstack_free(DynStack *stack)
+{
+    if (stack == NULL)
+    {
+        return;
+    }
+    free(stack->data);
+    stack->data = NULL;
+    stack->top = 0;
+    stack->capacity = 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * dstack_is_empty - Check if the stack is empty
+ * @param stack: Pointer to the stack
+ * @return: 1 if stack is empty, 0 otherwise
+ */
+int dstack_is_empty(DynStack *stack)
+{
+    return stack == NULL || stack->top == 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * dstack_push - Push an element, growing the buffer when full
+ * @param stack: Pointer to the stack
+ * @param element: Element to push onto the stack
+ * @return: 0 on success, -1 if the stack could not grow
+ */
+int dstack_push(DynStack *stack, int element)
+{
+    if (stack == NULL || stack->data == NULL)
+    {
+        return -1;
+    }
+    if (stack->top == stack->capacity && dstack_grow(stack) != 0)
+    {
+        return -1;
+    }
+    stack->data[stack->top++] = element;
+    return 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * dstack_pop - Remove and return the top element
+ * @param stack: Pointer to the stack
+ * @return: Top element if stack is not empty, -1 otherwise
+ */
+int dstack_pop(DynStack *stack)
+{
+    if (dstack_is_empty(stack))
+    {
+        return -1;
+    }
+    return stack->data[--stack->top];
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * dstack_peek - Return the top element without removing it
+ * @param stack: Pointer to the stack
+ * @return: Top element if stack is not empty, -1 otherwise
+ */
+int dstack_peek(DynStack *stack)
+{
+    if (dstack_is_empty(stack))
+    {
+        return -1;
+    }
+    return stack->data[stack->top - 1];
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * dstack_size - Return the number of elements in the stack
+ * @param stack: Pointer to the stack
+ * @return: Number of elements currently in the stack
+ */
+int dstack_size(DynStack *stack)
+{
+    return stack == NULL ? 0 : stack->top;
+}
+
+//------------------------------------------------------------------//
@@ -0,0 +1,341 @@
+// Hierarchical Bitmap - two-or-more level summary over a word bitmap
+// See ds_header.h for structure and prototype definitions
+// Used in: page frame allocation, PID allocation
+
+#include "ds_header.h"
+
+// Word helpers - bit n lives in word n / 64 at position n % 64
+#define WORD_INDEX(n) ((n) / BITMAP_WORD_BITS)
+#define WORD_OFFSET(n) ((n) % BITMAP_WORD_BITS)
+#define WORD_MASK(n) (1ULL << WORD_OFFSET(n))
+#define WORD_CTZ(w) __builtin_ctzll(w)
+
+//------------------------------------------------------------------//
+
+/**
+ * leaf_is_full - Check whether leaf word w has no zero bits left
+ * @param hb: Pointer to the hierarchical bitmap
+ * @param w: Leaf word index
+ * @return: 1 if every valid bit in the word is set, 0 otherwise
+ */
+static int leaf_is_full(HierBitmap *hb, int w)
+{
+    uint64_t word = hb->leaf.words[w];
+    // padding bits past nbits count as used
+    if (w == hb->nwords[0] - 1)
+    {
+        word |= ~BITMAP_TAIL_MASK(hb->leaf.nbits);
+    }
+    return word == ~0ULL;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * summary_update - Set or clear one summary bit and carry the change up
+ * @param summary: free_summary or used_summary of the bitmap
+ * @param levels: Number of summary levels
+ * @param index: Index of the level-0 word whose state changed
+ * @param on: 1 if the word now qualifies (has free / has used bits)
+ */
+static void summary_update(uint64_t **summary, int levels, int index, int on)
+{
+    for (int k = 1; k <= levels; k++)
+    {
+        uint64_t *word = &summary[k][WORD_INDEX(index)];
+        uint64_t old = *word;
+        *word = on ? old | WORD_MASK(index) : old & ~WORD_MASK(index);
+
+        // the level above only cares whether this word is zero or not
+        if ((old != 0) == (*word != 0))
+        {
+            return;
+        }
+        on = *word != 0;
+        index = WORD_INDEX(index);
+    }
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * used_next - Find the next used entry at summary level k
+ * @param hb: Pointer to the hierarchical bitmap
+ * @param k: Summary level (1..levels)
+ * @param pos: First position to consider
+ * @return: Smallest index >= pos with its bit set in used_summary[k], or -1
+ */
+static int used_next(HierBitmap *hb, int k, int pos)
+{
+    int w = WORD_INDEX(pos);
+    if (w >= hb->nwords[k])
+    {
+        return -1;
+    }
+
+    uint64_t word = hb->used_summary[k][w] & (~0ULL << WORD_OFFSET(pos));
+    if (word != 0)
+    {
+        return w * BITMAP_WORD_BITS + WORD_CTZ(word);
+    }
+    if (k == hb->levels)
+    {
+        return -1;
+    }
+
+    // ask the level above which later word is non-empty
+    int next = used_next(hb, k + 1, w + 1);
+    if (next < 0)
+    {
+        return -1;
+    }
+    return next * BITMAP_WORD_BITS + WORD_CTZ(hb->used_summary[k][next]);
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * hbitmap_init - Allocate a zeroed hierarchical bitmap
+ * @param hb: Pointer to the bitmap to initialize
+ * @param nbits: Number of bits (must be > 0)
+ * @return: 0 on success, -1 on invalid size or allocation failure
+ */
+int hbitmap_init(HierBitmap *hb, int nbits)
+{
+    if (hb == NULL || nbits <= 0)
+    {
+        return -1;
+    }
+
+    memset(hb, 0, sizeof(HierBitmap));
+    if (bitmap_init(&hb->leaf, nbits) != 0)
+    {
+        return -1;
+    }
+
+    // add summary levels until the top one fits in a single word
+    hb->nwords[0] = hb->leaf.nwords;
+    do
+    {
+        int k = ++hb->levels;
+        int entries = hb->nwords[k - 1];
+        hb->nwords[k] = BITMAP_WORDS(entries);
+        hb->free_summary[k] = (uint64_t *)malloc((size_t)hb->nwords[k] * sizeof(uint64_t));
+        hb->used_summary[k] = (uint64_t *)calloc((size_t)hb->nwords[k], sizeof(uint64_t));
+        if (hb->free_summary[k] == NULL || hb->used_summary[k] == NULL)
+        {
+            hbitmap_free(hb);
+            return -1;
+        }
+
+        // every word below starts out with free bits
+        memset(hb->free_summary[k], 0xFF, (size_t)hb->nwords[k] * sizeof(uint64_t));
+        hb->free_summary[k][hb->nwords[k] - 1] &= BITMAP_TAIL_MASK(entries);
+    } while (hb->nwords[hb->levels] > 1);
+
+    return 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * hbitmap_free - Release the bitmap and all summary levels
+ * @param hb: Pointer to the bitmap
+ */
+void hbitmap_free(HierBitmap *hb)
+{
+    if (hb == NULL)
+    {
+        return;
+    }
+    for (int k = 1; k <= hb->levels; k++)
+    {
+        free(hb->free_summary[k]);
+        free(hb->used_summary[k]);
+    }
+    bitmap_free(&hb->leaf);
+    memset(hb, 0, sizeof(HierBitmap));
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * hbitmap_set_bit - Set bit n to 1
+ * @param hb: Pointer to the bitmap
+ * @param n: Bit index to set (0-based)
+ */
+void hbitmap_set_bit(HierBitmap *hb, int n)
+{
+    if (hb == NULL || n < 0 || n >= hb->leaf.nbits)
+    {
+        return;
+    }
+
+    int w = WORD_INDEX(n);
+    uint64_t old = hb->leaf.words[w];
+    hb->leaf.words[w] |= WORD_MASK(n);
+    if (old == hb->leaf.words[w])
+    {
+        return;
+    }
+
+    if (old == 0)
+    {
+        summary_update(hb->used_summary, hb->levels, w, 1);
+    }
+    if (leaf_is_full(hb, w))
+    {
+        summary_update(hb->free_summary, hb->levels, w, 0);
+    }
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * hbitmap_clear_bit - Clear bit n to 0
+ * @param hb: Pointer to the bitmap
+ * @param n: Bit index to clear (0-based)
+ */
+void hbitmap_clear_bit(HierBitmap *hb, int n)
+{
+    if (hb == NULL || n < 0 || n >= hb->leaf.nbits)
+    {
+        return;
+    }
+
+    int w = WORD_INDEX(n);
+    int was_full = leaf_is_full(hb, w);
+    uint64_t old = hb->leaf.words[w];
+    hb->leaf.words[w] &= ~WORD_MASK(n);
+    if (old == hb->leaf.words[w])
+    {
+        return;
+    }
+
+    if (hb->leaf.words[w] == 0)
+    {
+        summary_update(hb->used_summary, hb->levels, w, 0);
+    }
+    if (was_full)
+    {
+        summary_update(hb->free_summary, hb->levels, w, 1);
+    }
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * hbitmap_test_bit - Test if bit n is set
+ * @param hb: Pointer to the bitmap
+ * @param n: Bit index to test (0-based)
+ * @return: 1 if set, 0 if clear, -1 if invalid index
+ */
+int hbitmap_test_bit(HierBitmap *hb, int n)
+{
+    return hb == NULL ? -1 : bitmap_test_bit(&hb->leaf, n);
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * hbitmap_find_first_zero_bit - Find first unset bit
+ * @param hb: Pointer to the bitmap
+ * @return: Index of first zero bit, or -1 if all bits are set
+ */
+int hbitmap_find_first_zero_bit(HierBitmap *hb)
+{
+    if (hb == NULL || hb->levels == 0 || hb->free_summary[hb->levels][0] == 0)
+    {
+        return -1;
+    }
+
+    // follow the lowest free entry from the top word down to the leaf
+    int index = WORD_CTZ(hb->free_summary[hb->levels][0]);
+    for (int k = hb->levels - 1; k >= 1; k--)
+    {
+        index = index * BITMAP_WORD_BITS + WORD_CTZ(hb->free_summary[k][index]);
+    }
+
+    uint64_t word = hb->leaf.words[index];
+    return index * BITMAP_WORD_BITS + WORD_CTZ(~word);
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * hbitmap_find_next_set_bit - Find next set bit after position start
+ * @param hb: Pointer to the bitmap
+ * @param start: Starting position to search from
+ * @return: Index of next set bit, or -1 if none found
+ */
+int hbitmap_find_next_set_bit(HierBitmap *hb, int start)
+{
+    if (hb == NULL || hb->leaf.nbits == 0 || start >= hb->leaf.nbits - 1)
+    {
+        return -1;
+    }
+    int n = start < 0 ? 0 : start + 1;
+
+    // rest of the current leaf word first
+    int w = WORD_INDEX(n);
+    uint64_t word = hb->leaf.words[w] & (~0ULL << WORD_OFFSET(n));
+    if (word != 0)
+    {
+        return w * BITMAP_WORD_BITS + WORD_CTZ(word);
+    }
+
+    // then the next non-empty leaf word according to the summaries
+    int next = used_next(hb, 1, w + 1);
+    if (next < 0)
+    {
+        return -1;
+    }
+    return next * BITMAP_WORD_BITS + WORD_CTZ(hb->leaf.words[next]);
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * hbitmap_alloc_bit - Claim the first unset bit
+ * @param hb: Pointer to the bitmap
+ * @return: Index of the bit that was set, or -1 if the bitmap is full
+ */
+int hbitmap_alloc_bit(HierBitmap *hb)
+{
+    int n = hbitmap_find_first_zero_bit(hb);
+    if (n >= 0)
+    {
+        hbitmap_set_bit(hb, n);
+    }
+    return n;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * hbitmap_is_empty - Check if all bits are 0
+ * @param hb: Pointer to the bitmap
+ * @return: 1 if all bits are 0, 0 if any bit is set
+ */
+int hbitmap_is_empty(HierBitmap *hb)
+{
+    if (hb == NULL || hb->levels == 0)
+    {
+        return 1;
+    }
+    return hb->used_summary[hb->levels][0] == 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * hbitmap_num_bits - Get the number of valid bits
+ * @param hb: Pointer to the bitmap
+ * @return: Number of bits in the bitmap
+ */
+int hbitmap_num_bits(HierBitmap *hb)
+{
+    return hb == NULL ? 0 : hb->leaf.nbits;
+}
+
+//------------------------------------------------------------------//
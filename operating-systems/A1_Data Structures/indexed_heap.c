@@ -0,0 +1,334 @@
+// Indexed Min-Heap - decrease_key/remove/contains by value handle
+// See ds_header.h for structure and prototype definitions
+#include "ds_header.h"
+
+// Helpful macros (for easier heap navigation):
+#define LEFT(i) (2 * (i) + 1)
+#define RIGHT(i) (2 * (i) + 2)
+#define PARENT(i) (((i) - 1) / 2)
+
+//------------------------------------------------------------------//
+
+/**
+ * place - Store an element at index i and record its position
+ */
+static void place(IndexedHeap *heap, int i, HeapNode element)
+{
+    heap->data[i] = element;
+    heap->pos[element.value] = i;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * sift_up - Move the element at index i up to its place
+ * @param heap: Pointer to the heap
+ * @param i: Index of the element that may be smaller than its parent
+ *
+ * Moves parents down into the hole instead of swapping, then writes
+ * the element once at its final index.
+ */
+static void sift_up(IndexedHeap *heap, int i)
+{
+    HeapNode element = heap->data[i];
+    while (i > 0 && heap->data[PARENT(i)].priority > element.priority)
+    {
+        place(heap, i, heap->data[PARENT(i)]);
+        i = PARENT(i);
+    }
+    place(heap, i, element);
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * sift_down - Move the element at index i down to its place
+ * @param heap: Pointer to the heap
+ * @param i: Index of the element that may be larger than its children
+ */
+static void sift_down(IndexedHeap *heap, int i)
+{
+    HeapNode element = heap->data[i];
+    for (;;)
+    {
+        int smallest = LEFT(i);
+        if (smallest >= heap->size)
+        {
+            break;
+        }
+        if (RIGHT(i) < heap->size && heap->data[RIGHT(i)].priority < heap->data[smallest].priority)
+        {
+            smallest = RIGHT(i);
+        }
+        if (heap->data[smallest].priority >= element.priority)
+        {
+            break;
+        }
+        place(heap, i, heap->data[smallest]);
+        i = smallest;
+    }
+    place(heap, i, element);
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * reserve_value - Make sure pos[] has an entry for value
+ * @return: 0 on success, -1 on allocation failure
+ */
+static int reserve_value(IndexedHeap *heap, int value)
+{
+    if (value < heap->pos_capacity)
+    {
+        return 0;
+    }
+    if (value == INT_MAX)
+    {
+        return -1;
+    }
+
+    int capacity = heap->pos_capacity > 0 ? heap->pos_capacity : 16;
+    while (capacity <= value)
+    {
+        capacity = capacity > INT_MAX / 2 ? INT_MAX : capacity * 2;
+    }
+
+    int *pos = (int *)realloc(heap->pos, (size_t)capacity * sizeof(int));
+    if (pos == NULL)
+    {
+        return -1;
+    }
+    for (int i = heap->pos_capacity; i < capacity; i++)
+    {
+        pos[i] = -1;
+    }
+    heap->pos = pos;
+    heap->pos_capacity = capacity;
+    return 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * iheap_init - Initialize an empty indexed heap
+ * @param heap: Pointer to the heap to initialize
+ * @param capacity: Initial number of slots (grows as needed)
+ * @return: 0 on success, -1 on allocation failure
+ */
+int iheap_init(IndexedHeap *heap, int capacity)
+{
+    if (heap == NULL)
+    {
+        return -1;
+    }
+
+    heap->capacity = capacity > 0 ? capacity : 16;
+    heap->data = (HeapNode *)malloc((size_t)heap->capacity * sizeof(HeapNode));
+    if (heap->data == NULL)
+    {
+        return -1;
+    }
+    heap->pos = NULL;
+    heap->pos_capacity = 0;
+    heap->size = 0;
+    return 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * iheap_free - Release the heap storage
+ * @param heap: Pointer to the heap
+ */
+void iheap_free(IndexedHeap *heap)
+{
+    if (heap == NULL)
+    {
+        return;
+    }
+    free(heap->data);
+    free(heap->pos);
+    heap->data = NULL;
+    heap->pos = NULL;
+    heap->size = 0;
+    heap->capacity = 0;
+    heap->pos_capacity = 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * iheap_insert - Insert a new element
+ * @param heap: Pointer to the heap
+ * @param element: Element to insert, its value is the handle
+ * @return: 0 on success, -1 if the value is negative, already in the heap,
+ *          or memory ran out
+ */
+int iheap_insert(IndexedHeap *heap, HeapNode element)
+{
+    if (heap == NULL || element.value < 0 || iheap_contains(heap, element.value))
+    {
+        return -1;
+    }
+    if (reserve_value(heap, element.value) != 0)
+    {
+        return -1;
+    }
+
+    if (heap->size == heap->capacity)
+    {
+        if (heap->capacity > INT_MAX / 2)
+        {
+            return -1;
+        }
+        HeapNode *data = (HeapNode *)realloc(heap->data, (size_t)heap->capacity * 2 * sizeof(HeapNode));
+        if (data == NULL)
+        {
+            return -1;
+        }
+        heap->data = data;
+        heap->capacity *= 2;
+    }
+
+    heap->data[heap->size] = element;
+    heap->size++;
+    sift_up(heap, heap->size - 1);
+    return 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * iheap_extract_min - Remove and return the element with minimum priority
+ * @param heap: Pointer to the heap
+ * @return: Minimum element, or {-1, INT_MAX} if the heap is empty
+ */
+HeapNode iheap_extract_min(IndexedHeap *heap)
+{
+    HeapNode dummy = {-1, INT_MAX};
+    if (heap == NULL || heap->size == 0)
+    {
+        return dummy;
+    }
+
+    HeapNode min = heap->data[0];
+    heap->pos[min.value] = -1;
+    heap->size--;
+    if (heap->size > 0)
+    {
+        heap->data[0] = heap->data[heap->size];
+        sift_down(heap, 0);
+    }
+    return min;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * iheap_peek - Return the element with minimum priority without removing it
+ * @param heap: Pointer to the heap
+ * @return: Minimum element, or {-1, INT_MAX} if the heap is empty
+ */
+HeapNode iheap_peek(IndexedHeap *heap)
+{
+    HeapNode dummy = {-1, INT_MAX};
+    if (heap == NULL || heap->size == 0)
+    {
+        return dummy;
+    }
+    return heap->data[0];
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * iheap_decrease_key - Lower the priority of the element with this value
+ * @param heap: Pointer to the heap
+ * @param value: Handle of the element to update
+ * @param new_priority: The new, lower priority value
+ * @return: 0 on success, -1 if value is not in the heap,
+ *          -2 if new_priority is higher than the current one
+ */
+int iheap_decrease_key(IndexedHeap *heap, int value, int new_priority)
+{
+    if (!iheap_contains(heap, value))
+    {
+        return -1;
+    }
+
+    int i = heap->pos[value];
+    if (new_priority > heap->data[i].priority)
+    {
+        return -2;
+    }
+    heap->data[i].priority = new_priority;
+    sift_up(heap, i);
+    return 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * iheap_remove - Remove the element with this value
+ * @param heap: Pointer to the heap
+ * @param value: Handle of the element to remove
+ * @return: 0 on success, -1 if value is not in the heap
+ */
+int iheap_remove(IndexedHeap *heap, int value)
+{
+    if (!iheap_contains(heap, value))
+    {
+        return -1;
+    }
+
+    int i = heap->pos[value];
+    heap->pos[value] = -1;
+    heap->size--;
+    if (i == heap->size)
+    {
+        return 0;
+    }
+
+    // the last element fills the gap and moves whichever way it must
+    heap->data[i] = heap->data[heap->size];
+    if (i > 0 && heap->data[PARENT(i)].priority > heap->data[i].priority)
+    {
+        sift_up(heap, i);
+    }
+    else
+    {
+        sift_down(heap, i);
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * iheap_contains - Check whether an element with this value is in the heap
+ * @param heap: Pointer to the heap
+ * @param value: Handle to look up
+ * @return: 1 if present, 0 otherwise
+ */
+int iheap_contains(IndexedHeap *heap, int value)
+{
+    if (heap == NULL || value < 0 || value >= heap->pos_capacity)
+    {
+        return 0;
+    }
+    return heap->pos[value] >= 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * iheap_size - Return the number of elements in the heap
+ * @param heap: Pointer to the heap
+ * @return: Number of elements
+ */
+int iheap_size(IndexedHeap *heap)
+{
+    return heap == NULL ? 0 : heap->size;
+}
+
+//------------------------------------------------------------------//
@@ -0,0 +1,100 @@
+// Intrusive Circular List - links embedded in caller-owned structs
+// See ds_header.h for structure and prototype definitions
+
+#include "ds_header.h"
+
+//------------------------------------------------------------------//
+
+/**
+ * clist_insert - Append a link at the tail of the ring
+ * @param head: Current head of the ring, NULL if empty
+ * @param link: Link to insert, must not already be in a ring
+ * @return: Head of the ring (link itself if the ring was empty)
+ */
+CListLink *clist_insert(CListLink *head, CListLink *link)
+{
+    if (link == NULL)
+    {
+        return head;
+    }
+    if (head == NULL)
+    {
+        link->next = link;
+        return link;
+    }
+
+    CListLink *last = head;
+    while (last->next != head)
+    {
+        last = last->next;
+    }
+    last->next = link;
+    link->next = head;
+    return head;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * clist_remove - Unlink a link from the ring
+ * @param head: Head of the ring
+ * @param link: Link to remove; its storage stays with the caller
+ * @return: New head of the ring, NULL if it is now empty.
+ *          The ring is unchanged if link is not in it.
+ */
+CListLink *clist_remove(CListLink *head, CListLink *link)
+{
+    if (head == NULL || link == NULL)
+    {
+        return head;
+    }
+    if (head->next == head)
+    {
+        if (head == link)
+        {
+            link->next = NULL;
+            return NULL;
+        }
+        return head;
+    }
+
+    // find the predecessor; it wraps around to the last link for the head
+    CListLink *prev = head;
+    while (prev->next != link)
+    {
+        prev = prev->next;
+        if (prev == head)
+        {
+            return head;
+        }
+    }
+    prev->next = link->next;
+    CListLink *new_head = link == head ? link->next : head;
+    link->next = NULL;
+    return new_head;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * clist_length - Count the links in the ring
+ * @param head: Head of the ring
+ * @return: Number of links, 0 if head is NULL
+ */
+int clist_length(CListLink *head)
+{
+    if (head == NULL)
+    {
+        return 0;
+    }
+    int count = 0;
+    CListLink *current = head;
+    do
+    {
+        count++;
+        current = current->next;
+    } while (current != head);
+    return count;
+}
+
+//------------------------------------------------------------------//
@@ -0,0 +1,164 @@
+// Multi-Producer/Multi-Consumer bounded queue - Vyukov's sequence cells
+// See ds_header.h for structure and prototype definitions
+
+#include "ds_header.h"
+
+//------------------------------------------------------------------//
+
+/**
+ * mpmc_init - Initialize a bounded MPMC queue
+ * @param queue: Pointer to the queue structure to initialize
+ * @param capacity: Capacity, rounded up to a power of two (at least 2)
+ * @return: 0 on success, -1 on allocation failure
+ */
+int mpmc_init(MpmcQueue *queue, int capacity)
+{
+    if (queue == NULL)
+    {
+        return -1;
+    }
+
+    // one slot would make "ready to write" and "ready to read" ambiguous
+    int rounded = ds_next_pow2(capacity < 2 ? 2 : capacity);
+    if (rounded < 0)
+    {
+        return -1;
+    }
+    queue->cells = (MpmcCell *)ds_aligned_alloc((size_t)rounded * sizeof(MpmcCell));
+    if (queue->cells == NULL)
+    {
+        return -1;
+    }
+
+    // cell i is ready for the producer that claims position i
+    for (int i = 0; i < rounded; i++)
+    {
+        atomic_init(&queue->cells[i].seq, (size_t)i);
+    }
+    queue->mask = (size_t)rounded - 1;
+    atomic_init(&queue->enqueue_pos, 0);
+    atomic_init(&queue->dequeue_pos, 0);
+    return 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * mpmc_free - Release the queue buffer
+ * @param queue: Pointer to the queue
+ */
+void mpmc_free(MpmcQueue *queue)
+{
+    if (queue == NULL)
+    {
+        return;
+    }
+    free(queue->cells);
+    queue->cells = NULL;
+    queue->mask = 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * mpmc_enqueue - Add an element to the rear
+ * @param queue: Pointer to the queue
+ * @param element: Element to add
+ * @return: 0 on success, -1 if queue is full
+ */
+int mpmc_enqueue(MpmcQueue *queue, int element)
+{
+    size_t pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+    MpmcCell *cell;
+
+    for (;;)
+    {
+        cell = &queue->cells[pos & queue->mask];
+        size_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+        if (diff == 0)
+        {
+            // cell is free for this lap, try to claim the position
+            if (atomic_compare_exchange_weak_explicit(&queue->enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // cell still holds the element from the previous lap
+            return -1;
+        }
+        else
+        {
+            // another producer took pos, reload and retry
+            pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    cell->data = element;
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+    return 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * mpmc_dequeue - Remove and return the front element
+ * @param queue: Pointer to the queue
+ * @return: Front element on success, -1 if queue is empty
+ */
+int mpmc_dequeue(MpmcQueue *queue)
+{
+    size_t pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+    MpmcCell *cell;
+
+    for (;;)
+    {
+        cell = &queue->cells[pos & queue->mask];
+        size_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+
+        if (diff == 0)
+        {
+            // cell holds an element for this lap, try to claim it
+            if (atomic_compare_exchange_weak_explicit(&queue->dequeue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // producer has not filled this cell yet
+            return -1;
+        }
+        else
+        {
+            pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+        }
+    }
+
+    int element = cell->data;
+    // mark the cell free for the producer one lap ahead
+    atomic_store_explicit(&cell->seq, pos + queue->mask + 1, memory_order_release);
+    return element;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * mpmc_size - Return the number of elements in the queue
+ * @param queue: Pointer to the queue
+ * @return: Number of elements (a snapshot while threads are active)
+ */
+int mpmc_size(MpmcQueue *queue)
+{
+    size_t head = atomic_load_explicit(&queue->dequeue_pos, memory_order_acquire);
+    size_t tail = atomic_load_explicit(&queue->enqueue_pos, memory_order_acquire);
+    return tail > head ? (int)(tail - head) : 0;
+}
+
+//------------------------------------------------------------------//
@@ -0,0 +1,108 @@
+// Node Pool - slab allocator with a free list for list nodes
+// See ds_header.h for structure and prototype definitions
+
+#include "ds_header.h"
+
+//------------------------------------------------------------------//
+
+/**
+ * node_pool_init - Initialize an empty pool
+ * @param pool: Pointer to the pool to initialize
+ * @param slab_nodes: Nodes per slab, <= 0 picks NODE_POOL_DEFAULT_SLAB
+ *
+ * No memory is allocated until the first node is requested.
+ */
+void node_pool_init(NodePool *pool, int slab_nodes)
+{
+    if (pool == NULL)
+    {
+        return;
+    }
+    pool->slabs = NULL;
+    pool->free_nodes = NULL;
+    pool->slab_nodes = slab_nodes > 0 ? slab_nodes : NODE_POOL_DEFAULT_SLAB;
+    pool->slab_used = 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * node_pool_alloc - Get a node from the pool
+ * @param pool: Pointer to the pool
+ * @return: Uninitialized node, or NULL if a new slab could not be allocated
+ *
+ * Recycled nodes are reused first (most recently released, so still warm
+ * in cache); otherwise nodes are carved from the newest slab in order.
+ */
+Node *node_pool_alloc(NodePool *pool)
+{
+    if (pool == NULL)
+    {
+        return NULL;
+    }
+
+    if (pool->free_nodes != NULL)
+    {
+        Node *node = pool->free_nodes;
+        pool->free_nodes = node->next;
+        return node;
+    }
+
+    if (pool->slabs == NULL || pool->slab_used == pool->slab_nodes)
+    {
+        NodeSlab *slab = (NodeSlab *)malloc(sizeof(NodeSlab) + (size_t)pool->slab_nodes * sizeof(Node));
+        if (slab == NULL)
+        {
+            return NULL;
+        }
+        slab->next = pool->slabs;
+        pool->slabs = slab;
+        pool->slab_used = 0;
+    }
+    return &pool->slabs->nodes[pool->slab_used++];
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * node_pool_release - Return a node to the pool for reuse
+ * @param pool: Pointer to the pool the node came from
+ * @param node: Node to recycle, must not be used afterwards
+ */
+void node_pool_release(NodePool *pool, Node *node)
+{
+    if (pool == NULL || node == NULL)
+    {
+        return;
+    }
+    node->next = pool->free_nodes;
+    pool->free_nodes = node;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * node_pool_destroy - Free every slab in the pool
+ * @param pool: Pointer to the pool
+ *
+ * Costs one free() per slab however many nodes were handed out, so a
+ * whole list can be dropped without walking it. Every node from this
+ * pool becomes invalid; the pool is left empty and ready for reuse.
+ */
+void node_pool_destroy(NodePool *pool)
+{
+    if (pool == NULL)
+    {
+        return;
+    }
+    while (pool->slabs != NULL)
+    {
+        NodeSlab *next = pool->slabs->next;
+        free(pool->slabs);
+        pool->slabs = next;
+    }
+    pool->free_nodes = NULL;
+    pool->slab_used = 0;
+}
+
+//------------------------------------------------------------------//
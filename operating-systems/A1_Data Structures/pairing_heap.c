@@ -0,0 +1,247 @@
+// Pairing Heap - O(1) insert and meld, two-pass extract_min
+// See ds_header.h for structure and prototype definitions
+#include "ds_header.h"
+
+//------------------------------------------------------------------//
+
+/**
+ * link - Meld two heap-ordered trees
+ * @param a: Root of the first tree (sibling must be NULL)
+ * @param b: Root of the second tree (sibling must be NULL)
+ * @return: Root of the melded tree; the larger root becomes its first child
+ */
+static PairingNode *link(PairingNode *a, PairingNode *b)
+{
+    if (a == NULL)
+    {
+        return b;
+    }
+    if (b == NULL)
+    {
+        return a;
+    }
+    if (b->item.priority < a->item.priority)
+    {
+        PairingNode *temp = a;
+        a = b;
+        b = temp;
+    }
+    b->sibling = a->child;
+    a->child = b;
+    return a;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * merge_pairs - Two-pass merge of a sibling list into one tree
+ * @param first: First node of the sibling list
+ * @return: Root of the merged tree, or NULL for an empty list
+ */
+static PairingNode *merge_pairs(PairingNode *first)
+{
+    // pass 1: link neighbours left to right, pushing each result onto a
+    // reversed list so pass 2 can walk it right to left without recursion
+    PairingNode *pairs = NULL;
+    while (first != NULL)
+    {
+        PairingNode *a = first;
+        PairingNode *b = a->sibling;
+        if (b == NULL)
+        {
+            a->sibling = pairs;
+            pairs = a;
+            break;
+        }
+        first = b->sibling;
+        a->sibling = NULL;
+        b->sibling = NULL;
+        PairingNode *merged = link(a, b);
+        merged->sibling = pairs;
+        pairs = merged;
+    }
+
+    // pass 2: fold the pairs into a single tree
+    PairingNode *root = NULL;
+    while (pairs != NULL)
+    {
+        PairingNode *next = pairs->sibling;
+        pairs->sibling = NULL;
+        root = link(root, pairs);
+        pairs = next;
+    }
+    return root;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * pheap_init - Initialize an empty pairing heap
+ * @param heap: Pointer to the heap to initialize
+ */
+void pheap_init(PairingHeap *heap)
+{
+    if (heap == NULL)
+    {
+        return;
+    }
+    heap->root = NULL;
+    heap->free_nodes = NULL;
+    heap->size = 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * pheap_free - Release every node of the heap and its free list
+ * @param heap: Pointer to the heap
+ */
+void pheap_free(PairingHeap *heap)
+{
+    if (heap == NULL)
+    {
+        return;
+    }
+
+    // view child/sibling as left/right and rotate left children away so
+    // the tree is freed without recursion or an explicit stack
+    PairingNode *node = heap->root;
+    while (node != NULL)
+    {
+        if (node->child != NULL)
+        {
+            PairingNode *child = node->child;
+            node->child = child->sibling;
+            child->sibling = node;
+            node = child;
+        }
+        else
+        {
+            PairingNode *next = node->sibling;
+            free(node);
+            node = next;
+        }
+    }
+
+    while (heap->free_nodes != NULL)
+    {
+        PairingNode *next = heap->free_nodes->sibling;
+        free(heap->free_nodes);
+        heap->free_nodes = next;
+    }
+    heap->root = NULL;
+    heap->size = 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * pheap_insert - Insert a new element in O(1)
+ * @param heap: Pointer to the heap
+ * @param element: The HeapNode to insert
+ * @return: 0 on success, -1 on allocation failure
+ */
+int pheap_insert(PairingHeap *heap, HeapNode element)
+{
+    if (heap == NULL)
+    {
+        return -1;
+    }
+
+    PairingNode *node = heap->free_nodes;
+    if (node != NULL)
+    {
+        heap->free_nodes = node->sibling;
+    }
+    else
+    {
+        node = (PairingNode *)malloc(sizeof(PairingNode));
+        if (node == NULL)
+        {
+            return -1;
+        }
+    }
+
+    node->item = element;
+    node->child = NULL;
+    node->sibling = NULL;
+    heap->root = link(heap->root, node);
+    heap->size++;
+    return 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * pheap_extract_min - Remove and return the element with minimum priority
+ * @param heap: Pointer to the heap
+ * @return: Minimum element, or {-1, INT_MAX} if the heap is empty
+ */
+HeapNode pheap_extract_min(PairingHeap *heap)
+{
+    HeapNode dummy = {-1, INT_MAX};
+    if (heap == NULL || heap->root == NULL)
+    {
+        return dummy;
+    }
+
+    PairingNode *root = heap->root;
+    HeapNode min = root->item;
+    heap->root = merge_pairs(root->child);
+    heap->size--;
+
+    // recycle the node for the next insert
+    root->sibling = heap->free_nodes;
+    heap->free_nodes = root;
+    return min;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * pheap_peek - Return the element with minimum priority without removing it
+ * @param heap: Pointer to the heap
+ * @return: Minimum element, or {-1, INT_MAX} if the heap is empty
+ */
+HeapNode pheap_peek(PairingHeap *heap)
+{
+    HeapNode dummy = {-1, INT_MAX};
+    if (heap == NULL || heap->root == NULL)
+    {
+        return dummy;
+    }
+    return heap->root->item;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * pheap_meld - Move all elements of other into heap in O(1)
+ * @param heap: Pointer to the destination heap
+ * @param other: Pointer to the source heap (left empty, keeps its free list)
+ */
+void pheap_meld(PairingHeap *heap, PairingHeap *other)
+{
+    if (heap == NULL || other == NULL || heap == other)
+    {
+        return;
+    }
+    heap->root = link(heap->root, other->root);
+    heap->size += other->size;
+    other->root = NULL;
+    other->size = 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * pheap_size - Return the number of elements in the heap
+ * @param heap: Pointer to the heap
+ * @return: Number of elements
+ */
+int pheap_size(PairingHeap *heap)
+{
+    return heap == NULL ? 0 : heap->size;
+}
+
+//------------------------------------------------------------------//
@@ -0,0 +1,197 @@
+// Priority Queue - common interface over MinHeap, DaryHeap and PairingHeap
+// See ds_header.h for structure and prototype definitions
+#include "ds_header.h"
+
+//------------------------------------------------------------------//
+
+/**
+ * pq_init - Initialize a priority queue with the chosen backend
+ * @param pq: Pointer to the priority queue
+ * @param kind: PQ_BINARY, PQ_DARY or PQ_PAIRING
+ * @return: 0 on success, -1 on unknown kind or allocation failure
+ */
+int pq_init(PriorityQueue *pq, int kind)
+{
+    if (pq == NULL)
+    {
+        return -1;
+    }
+
+    pq->kind = kind;
+    switch (kind)
+    {
+    case PQ_BINARY:
+        pq->impl.binary.size = 0;
+        return 0;
+    case PQ_DARY:
+        return dheap_init(&pq->impl.dary, 16);
+    case PQ_PAIRING:
+        pheap_init(&pq->impl.pairing);
+        return 0;
+    default:
+        return -1;
+    }
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * pq_free - Release the backend storage
+ * @param pq: Pointer to the priority queue
+ */
+void pq_free(PriorityQueue *pq)
+{
+    if (pq == NULL)
+    {
+        return;
+    }
+    switch (pq->kind)
+    {
+    case PQ_BINARY:
+        pq->impl.binary.size = 0;
+        break;
+    case PQ_DARY:
+        dheap_free(&pq->impl.dary);
+        break;
+    case PQ_PAIRING:
+        pheap_free(&pq->impl.pairing);
+        break;
+    }
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * pq_insert - Insert an element
+ * @param pq: Pointer to the priority queue
+ * @param element: The HeapNode to insert
+ * @return: 0 on success, -1 if the backend is full or out of memory
+ */
+int pq_insert(PriorityQueue *pq, HeapNode element)
+{
+    if (pq == NULL)
+    {
+        return -1;
+    }
+    switch (pq->kind)
+    {
+    case PQ_BINARY:
+        // insert_element silently ignores a full heap
+        if (pq->impl.binary.size >= MAX_SIZE)
+        {
+            return -1;
+        }
+        insert_element(&pq->impl.binary, element);
+        return 0;
+    case PQ_DARY:
+        return dheap_insert(&pq->impl.dary, element);
+    case PQ_PAIRING:
+        return pheap_insert(&pq->impl.pairing, element);
+    default:
+        return -1;
+    }
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * pq_extract_min - Remove and return the element with minimum priority
+ * @param pq: Pointer to the priority queue
+ * @return: Minimum element, or {-1, INT_MAX} if empty
+ */
+HeapNode pq_extract_min(PriorityQueue *pq)
+{
+    HeapNode dummy = {-1, INT_MAX};
+    if (pq == NULL)
+    {
+        return dummy;
+    }
+    switch (pq->kind)
+    {
+    case PQ_BINARY:
+        return extract_min(&pq->impl.binary);
+    case PQ_DARY:
+        return dheap_extract_min(&pq->impl.dary);
+    case PQ_PAIRING:
+        return pheap_extract_min(&pq->impl.pairing);
+    default:
+        return dummy;
+    }
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * pq_peek - Return the element with minimum priority without removing it
+ * @param pq: Pointer to the priority queue
+ * @return: Minimum element, or {-1, INT_MAX} if empty
+ */
+HeapNode pq_peek(PriorityQueue *pq)
+{
+    HeapNode dummy = {-1, INT_MAX};
+    if (pq == NULL)
+    {
+        return dummy;
+    }
+    switch (pq->kind)
+    {
+    case PQ_BINARY:
+        return peek_heap(&pq->impl.binary);
+    case PQ_DARY:
+        return dheap_peek(&pq->impl.dary);
+    case PQ_PAIRING:
+        return pheap_peek(&pq->impl.pairing);
+    default:
+        return dummy;
+    }
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * pq_size - Return the number of elements
+ * @param pq: Pointer to the priority queue
+ * @return: Number of elements
+ */
+int pq_size(PriorityQueue *pq)
+{
+    if (pq == NULL)
+    {
+        return 0;
+    }
+    switch (pq->kind)
+    {
+    case PQ_BINARY:
+        return pq->impl.binary.size;
+    case PQ_DARY:
+        return dheap_size(&pq->impl.dary);
+    case PQ_PAIRING:
+        return pheap_size(&pq->impl.pairing);
+    default:
+        return 0;
+    }
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * pq_name - Human-readable backend name
+ * @param kind: PQ_BINARY, PQ_DARY or PQ_PAIRING
+ * @return: Name string
+ */
+const char *pq_name(int kind)
+{
+    switch (kind)
+    {
+    case PQ_BINARY:
+        return "binary";
+    case PQ_DARY:
+        return "4-ary";
+    case PQ_PAIRING:
+        return "pairing";
+    default:
+        return "unknown";
+    }
+}
+
+//------------------------------------------------------------------//
@@ -0,0 +1,126 @@
+// Single-Producer/Single-Consumer ring buffer - wait-free
+// See ds_header.h for structure and prototype definitions
+
+#include "ds_header.h"
+
+//------------------------------------------------------------------//
+
+/**
+ * spsc_init - Initialize an SPSC ring buffer
+ * @param queue: Pointer to the queue structure to initialize
+ * @param capacity: Capacity, rounded up to a power of two
+ * @return: 0 on success, -1 on allocation failure
+ */
+int spsc_init(SpscQueue *queue, int capacity)
+{
+    if (queue == NULL)
+    {
+        return -1;
+    }
+
+    int rounded = ds_next_pow2(capacity);
+    if (rounded < 0)
+    {
+        return -1;
+    }
+    queue->data = (int *)ds_aligned_alloc((size_t)rounded * sizeof(int));
+    if (queue->data == NULL)
+    {
+        return -1;
+    }
+    queue->mask = (unsigned int)rounded - 1;
+    atomic_init(&queue->head, 0);
+    atomic_init(&queue->tail, 0);
+    queue->cached_head = 0;
+    queue->cached_tail = 0;
+    return 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * spsc_free - Release the queue buffer
+ * @param queue: Pointer to the queue
+ */
+void spsc_free(SpscQueue *queue)
+{
+    if (queue == NULL)
+    {
+        return;
+    }
+    free(queue->data);
+    queue->data = NULL;
+    queue->mask = 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * spsc_enqueue - Add an element to the rear (producer thread only)
+ * @param queue: Pointer to the queue
+ * @param element: Element to add
+ * @return: 0 on success, -1 if queue is full
+ */
+int spsc_enqueue(SpscQueue *queue, int element)
+{
+    // only the producer writes tail, so a relaxed load is exact
+    unsigned int tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+
+    // re-read the consumer's head only when the cached copy says full
+    if (tail - queue->cached_head > queue->mask)
+    {
+        queue->cached_head = atomic_load_explicit(&queue->head, memory_order_acquire);
+        if (tail - queue->cached_head > queue->mask)
+        {
+            return -1;
+        }
+    }
+
+    queue->data[tail & queue->mask] = element;
+    // release publishes the element before the new tail
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+    return 0;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * spsc_dequeue - Remove and return the front element (consumer thread only)
+ * @param queue: Pointer to the queue
+ * @return: Front element on success, -1 if queue is empty
+ */
+int spsc_dequeue(SpscQueue *queue)
+{
+    unsigned int head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+
+    // re-read the producer's tail only when the cached copy says empty
+    if (head == queue->cached_tail)
+    {
+        queue->cached_tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+        if (head == queue->cached_tail)
+        {
+            return -1;
+        }
+    }
+
+    int element = queue->data[head & queue->mask];
+    // release hands the slot back to the producer after reading it
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+    return element;
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * spsc_size - Return the number of elements in the queue
+ * @param queue: Pointer to the queue
+ * @return: Number of elements (a snapshot while both sides are active)
+ */
+int spsc_size(SpscQueue *queue)
+{
+    unsigned int head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    unsigned int tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    return (int)(tail - head);
+}
+
+//------------------------------------------------------------------//
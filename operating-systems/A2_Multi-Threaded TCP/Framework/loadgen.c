@@ -0,0 +1,529 @@
+/**
+ * loadgen.c - Load generator and benchmark for the shell server
+ *
+ * Connection storm (default): opens connections to a running server from
+ * several threads as fast as it can and reports accepted connections per
+ * second. Each connection reads the welcome response, sends EXIT, reads
+ * the goodbye response and closes, so the server does the full accept /
+ * serve / close cycle every time.
+ *
+ * Command load (-c command): every thread keeps one connection and runs a
+ * closed loop: send a command, wait for the whole response, send the next.
+ * Give -c several times for a mix; "W:command" weights an entry (default
+ * 1), and each command picks an entry at random by weight. Reports
+ * commands and response bytes per second over all the clients and the
+ * latency (send to end of response) of every mix entry: mean, p50, p99,
+ * p99.9 and max, from log-linear histograms accurate to about 6%.
+ *
+ * -d seconds runs for that long instead of a fixed count. -f switches each
+ * connection to the framed protocol, and -p keeps up to that many framed
+ * requests in flight per connection (the server runs them concurrently,
+ * see --pipeline); latency then includes the time queued behind them.
+ *
+ * Compare server configurations by running it against each of them:
+ *   ./server > /dev/null &                       (worker pool, default)
+ *   ./server --thread-per-client > /dev/null &   (thread per connection)
+ *   ./server --spawn fork > /dev/null &          (fork + exec per command)
+ * for example with
+ *   ./loadgen -t 32 -d 10 -c '8:echo hi' -c '1:sleep 0.1' -c '1:seq 100000'
+ *
+ * Build and run with:
+ *   gcc loadgen.c -o loadgen -lpthread -Wall -Wextra -Werror -std=c17
+ *   ./loadgen [-t threads] [-n connections | commands] [-d seconds] [-c [W:]command]... [-f [-p depth]]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#define _GNU_SOURCE     // memmem
+#include "shell_server.h"
+
+#define LOADGEN_DEFAULT_THREADS 16
+#define LOADGEN_DEFAULT_CONNECTIONS 20000
+#define LOADGEN_DEFAULT_COMMANDS 2000
+#define LOADGEN_MAX_MIX 8
+#define LOADGEN_MAX_DEPTH 64
+
+// Latency histogram: 16 linear sub-buckets per power of two microseconds
+#define HIST_SUB_BITS 4
+#define HIST_SUB_BUCKETS (1 << HIST_SUB_BITS)
+#define HIST_BUCKETS ((64 - HIST_SUB_BITS + 1) * HIST_SUB_BUCKETS)
+
+typedef struct {
+    uint64_t buckets[HIST_BUCKETS];
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+} Histogram;
+
+typedef struct {
+    const char* command;
+    int weight;
+} MixEntry;
+
+typedef struct {
+    int count;              // connections (storm) or commands this thread runs; 0 with -d
+    int completed;          // full cycles, or commands answered
+    int failed;             // connect, send or receive errors
+    uint64_t bytes;         // response bytes received
+    unsigned int seed;      // rand_r state for picking mix entries
+    Histogram latency[LOADGEN_MAX_MIX];
+} LoadWorker;
+
+static MixEntry mix[LOADGEN_MAX_MIX];
+static int mix_count = 0;
+static int mix_weight = 0;              // sum of the weights
+static int framed = 0;
+static int depth = 1;                   // framed requests in flight per connection
+static double deadline = 0;             // -d: stop sending at this time, 0 = use the count
+
+//------------------------------------------------------------------//
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static int hist_index(uint64_t us) {
+    if (us < HIST_SUB_BUCKETS) {
+        return (int)us;
+    }
+    int exponent = 63 - __builtin_clzll(us);
+    return (exponent - HIST_SUB_BITS + 1) * HIST_SUB_BUCKETS
+           + (int)((us >> (exponent - HIST_SUB_BITS)) & (HIST_SUB_BUCKETS - 1));
+}
+
+static uint64_t hist_bucket_top(int index) {
+    if (index < HIST_SUB_BUCKETS) {
+        return (uint64_t)index;
+    }
+    int exponent = index / HIST_SUB_BUCKETS + HIST_SUB_BITS - 1;
+    uint64_t sub = (uint64_t)(index % HIST_SUB_BUCKETS);
+    return ((HIST_SUB_BUCKETS + sub + 1) << (exponent - HIST_SUB_BITS)) - 1;
+}
+
+static void hist_record(Histogram* h, double seconds) {
+    uint64_t us = (uint64_t)(seconds * 1e6);
+    h->buckets[hist_index(us)]++;
+    h->count++;
+    h->sum += us;
+    if (us > h->max) {
+        h->max = us;
+    }
+}
+
+static void hist_merge(Histogram* into, const Histogram* h) {
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        into->buckets[i] += h->buckets[i];
+    }
+    into->count += h->count;
+    into->sum += h->sum;
+    if (h->max > into->max) {
+        into->max = h->max;
+    }
+}
+
+static uint64_t hist_percentile(const Histogram* h, double share) {
+    uint64_t rank = (uint64_t)(share * (double)h->count + 0.5);
+    uint64_t seen = 0;
+    if (rank == 0) {
+        rank = 1;
+    }
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen >= rank) {
+            return hist_bucket_top(i) < h->max ? hist_bucket_top(i) : h->max;
+        }
+    }
+    return h->max;
+}
+
+static void print_latency(const char* name, const Histogram* h) {
+    if (h->count == 0) {
+        printf("  %-28.28s %10d\n", name, 0);
+        return;
+    }
+    printf("  %-28.28s %10llu %9llu %9llu %9llu %9llu %9llu\n", name, (unsigned long long)h->count,
+           (unsigned long long)(h->sum / h->count), (unsigned long long)hist_percentile(h, 0.50),
+           (unsigned long long)hist_percentile(h, 0.99), (unsigned long long)hist_percentile(h, 0.999),
+           (unsigned long long)h->max);
+}
+
+//------------------------------------------------------------------//
+
+/**
+ * Read until RESPONSE_END_MARKER has been received
+ * The last bytes of every chunk are carried over so a marker split across
+ * two recv calls is still found. Returns the bytes received, -1 on EOF or
+ * error.
+ */
+static long read_response(int sock) {
+    const size_t keep = sizeof(RESPONSE_END_MARKER) - 2;
+    char buffer[BUFFER_SIZE + sizeof(RESPONSE_END_MARKER) - 2];
+    size_t carried = 0;
+    long total = 0;
+
+    while (1) {
+        ssize_t n = recv(sock, buffer + carried, BUFFER_SIZE, 0);
+        if (n <= 0) {
+            return -1;
+        }
+        total += n;
+        size_t len = carried + (size_t)n;
+        // output may contain NUL bytes, so search by length, not as a string
+        if (memmem(buffer, len, RESPONSE_END_MARKER, sizeof(RESPONSE_END_MARKER) - 1) != NULL) {
+            return total;
+        }
+        carried = len < keep ? len : keep;
+        memmove(buffer, buffer + len - carried, carried);
+    }
+}
+
+static int recv_exact(int sock, void* buf, size_t len) {
+    size_t got = 0;
+    while (got < len) {
+        ssize_t n = recv(sock, (char*)buf + got, len - got, 0);
+        if (n <= 0) {
+            return -1;
+        }
+        got += (size_t)n;
+    }
+    return 0;
+}
+
+static int send_all(int sock, const void* buf, size_t len) {
+    size_t sent = 0;
+    while (sent < len) {
+        ssize_t n = send(sock, (const char*)buf + sent, len - sent, 0);
+        if (n <= 0) {
+            return -1;
+        }
+        sent += (size_t)n;
+    }
+    return 0;
+}
+
+static int open_connection(void) {
+    struct sockaddr_in server_addr;
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) {
+        return -1;
+    }
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(SERVER_PORT);
+    inet_pton(AF_INET, SERVER_IP, &server_addr.sin_addr);
+    if (connect(sock, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+/**
+ * Connect, read the welcome and switch to framing if -f was given
+ * Returns the socket, or -1 if any step failed.
+ */
+static int open_session(void) {
+    static const char hello[] = PROTOCOL_FRAMED_REQUEST "\n";
+    static const char expected[] = PROTOCOL_FRAMED_REPLY RESPONSE_END_MARKER "\n";
+    char reply[sizeof(expected)];
+
+    int sock = open_connection();
+    if (sock < 0) {
+        return -1;
+    }
+    if (read_response(sock) < 0) {
+        close(sock);
+        return -1;
+    }
+    if (framed) {
+        // read exactly the reply, so no frame bytes are consumed with it
+        if (send_all(sock, hello, sizeof(hello) - 1) < 0
+            || recv_exact(sock, reply, sizeof(reply) - 1) < 0
+            || memcmp(reply, expected, sizeof(reply) - 1) != 0) {
+            close(sock);
+            return -1;
+        }
+    }
+    return sock;
+}
+
+/**
+ * Pick a mix entry at random by weight
+ */
+static int pick_entry(LoadWorker* w) {
+    int roll = (int)(rand_r(&w->seed) % (unsigned int)mix_weight);
+    int i = 0;
+    while (roll >= mix[i].weight) {
+        roll -= mix[i].weight;
+        i++;
+    }
+    return i;
+}
+
+/**
+ * Whether the worker should send another command; a count of 0 means run
+ * until the deadline
+ */
+static int more_to_send(LoadWorker* w, int sent) {
+    return w->count > 0 ? sent < w->count : now_sec() < deadline;
+}
+
+//------------------------------------------------------------------//
+
+static void* storm_thread(void* arg) {
+    LoadWorker* w = (LoadWorker*)arg;
+    static const char exit_cmd[] = "EXIT\n";
+
+    for (int i = 0; more_to_send(w, i); i++) {
+        int sock = open_connection();
+        if (sock < 0) {
+            w->failed++;
+            continue;
+        }
+        if (read_response(sock) >= 0
+            && send(sock, exit_cmd, sizeof(exit_cmd) - 1, 0) == (ssize_t)(sizeof(exit_cmd) - 1)
+            && read_response(sock) >= 0) {
+            w->completed++;
+        } else {
+            w->failed++;
+        }
+        close(sock);
+    }
+    return NULL;
+}
+
+static void* command_thread(void* arg) {
+    LoadWorker* w = (LoadWorker*)arg;
+    char line[BUFFER_SIZE + 1];
+
+    int sock = open_session();
+    if (sock < 0) {
+        w->failed = w->count > 0 ? w->count : 1;
+        return NULL;
+    }
+    for (int sent = 0; more_to_send(w, sent); sent++) {
+        int entry = pick_entry(w);
+        int len = snprintf(line, sizeof(line), "%s\n", mix[entry].command);
+        double start = now_sec();
+        long got;
+        if (send_all(sock, line, (size_t)len) < 0 || (got = read_response(sock)) < 0) {
+            w->failed += w->count > 0 ? w->count - sent : 1;
+            break;
+        }
+        hist_record(&w->latency[entry], now_sec() - start);
+        w->bytes += (uint64_t)got;
+        w->completed++;
+    }
+    close(sock);
+    return NULL;
+}
+
+/**
+ * Framed closed loop: keep up to depth requests in flight, and send a new
+ * one each time a FRAME_END comes back
+ * The server answers in completion order, so each request takes a free
+ * slot, sends the slot index as its request id and gives the slot back
+ * when its FRAME_END arrives.
+ */
+static void* framed_thread(void* arg) {
+    LoadWorker* w = (LoadWorker*)arg;
+    unsigned char request[FRAME_HEADER_SIZE + FRAME_MAX_COMMAND];
+    unsigned char header[FRAME_HEADER_SIZE];
+    char payload[BUFFER_SIZE];
+    int entries[LOADGEN_MAX_DEPTH];     // in-flight requests, indexed by slot (= request id)
+    double started[LOADGEN_MAX_DEPTH];
+    uint32_t free_slots[LOADGEN_MAX_DEPTH];
+    int inflight = 0;                   // slots in use; the free ones are free_slots[0 .. depth - inflight)
+    int sent = 0;
+
+    for (int i = 0; i < depth; i++) {
+        free_slots[i] = (uint32_t)(depth - 1 - i);
+    }
+
+    int sock = open_session();
+    if (sock < 0) {
+        w->failed = w->count > 0 ? w->count : 1;
+        return NULL;
+    }
+    while (1) {
+        while (inflight < depth && more_to_send(w, sent)) {
+            int entry = pick_entry(w);
+            uint32_t slot = free_slots[depth - 1 - inflight];
+            size_t len = strlen(mix[entry].command);
+            FrameHeader h = {.length = (uint32_t)len, .request_id = slot, .type = FRAME_REQUEST};
+            frame_encode(request, &h);
+            memcpy(request + FRAME_HEADER_SIZE, mix[entry].command, len);
+            entries[slot] = entry;
+            started[slot] = now_sec();
+            if (send_all(sock, request, FRAME_HEADER_SIZE + len) < 0) {
+                goto failed;
+            }
+            inflight++;
+            sent++;
+        }
+        if (inflight == 0) {
+            break;
+        }
+
+        FrameHeader h;
+        if (recv_exact(sock, header, sizeof(header)) < 0) {
+            goto failed;
+        }
+        frame_decode(header, &h);
+        for (uint32_t left = h.length; left > 0;) {
+            size_t chunk = left < sizeof(payload) ? left : sizeof(payload);
+            if (recv_exact(sock, payload, chunk) < 0) {
+                goto failed;
+            }
+            left -= (uint32_t)chunk;
+        }
+        w->bytes += FRAME_HEADER_SIZE + h.length;
+        if (h.type == FRAME_END) {
+            uint32_t slot = h.request_id;
+            if (slot >= (uint32_t)depth || inflight == 0) {
+                goto failed;            // not a request of ours
+            }
+            hist_record(&w->latency[entries[slot]], now_sec() - started[slot]);
+            inflight--;
+            free_slots[depth - 1 - inflight] = slot;
+            w->completed++;
+        }
+    }
+    close(sock);
+    return NULL;
+
+failed:
+    w->failed += w->count > 0 ? w->count - w->completed : inflight > 0 ? inflight : 1;
+    close(sock);
+    return NULL;
+}
+
+/**
+ * Add a -c argument to the mix: "command" or "weight:command"
+ */
+static int add_mix_entry(const char* arg) {
+    const char* colon = strchr(arg, ':');
+    int weight = 1;
+    if (colon != NULL && colon > arg && strspn(arg, "0123456789") == (size_t)(colon - arg)) {
+        weight = atoi(arg);
+        arg = colon + 1;
+    }
+    if (mix_count == LOADGEN_MAX_MIX || weight < 1 || *arg == '\0' || strlen(arg) > FRAME_MAX_COMMAND) {
+        return -1;
+    }
+    mix[mix_count].command = arg;
+    mix[mix_count++].weight = weight;
+    mix_weight += weight;
+    return 0;
+}
+
+static void print_usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [-t threads] [-n connections | commands] [-d seconds] [-c [W:]command]..."
+                    " [-f [-p depth]]\n", prog);
+    fprintf(stderr, "  -t threads   concurrent connections (default %d)\n", LOADGEN_DEFAULT_THREADS);
+    fprintf(stderr, "  -n count     connections, or commands with -c, over all threads\n");
+    fprintf(stderr, "  -d seconds   run for this long instead of a count\n");
+    fprintf(stderr, "  -c [W:]cmd   command load; repeat for a mix, W weights the entry (default 1)\n");
+    fprintf(stderr, "  -f           use the framed protocol\n");
+    fprintf(stderr, "  -p depth     framed requests in flight per connection (default 1, at most %d)\n",
+            LOADGEN_MAX_DEPTH);
+}
+
+int main(int argc, char* argv[]) {
+    int threads = LOADGEN_DEFAULT_THREADS;
+    int count = 0;
+    double duration = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "t:n:d:c:fp:")) != -1) {
+        if (opt == 't') {
+            threads = atoi(optarg);
+        } else if (opt == 'n') {
+            count = atoi(optarg);
+        } else if (opt == 'd') {
+            duration = atof(optarg);
+        } else if (opt == 'c' && add_mix_entry(optarg) == 0) {
+            continue;
+        } else if (opt == 'f') {
+            framed = 1;
+        } else if (opt == 'p') {
+            depth = atoi(optarg);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (depth < 1 || depth > LOADGEN_MAX_DEPTH || (depth > 1 && !framed) || (framed && mix_count == 0)) {
+        fprintf(stderr, "-p needs -f and 1..%d, and -f needs -c\n", LOADGEN_MAX_DEPTH);
+        return 1;
+    }
+    if (duration > 0) {
+        count = 0;
+    } else if (count == 0) {
+        count = mix_count > 0 ? LOADGEN_DEFAULT_COMMANDS : LOADGEN_DEFAULT_CONNECTIONS;
+    }
+    if (threads < 1 || (duration <= 0 && count < threads)) {
+        fprintf(stderr, "Need at least one thread and one connection or command per thread\n");
+        return 1;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    LoadWorker* workers = calloc((size_t)threads, sizeof(LoadWorker));
+    pthread_t* tids = calloc((size_t)threads, sizeof(pthread_t));
+    if (workers == NULL || tids == NULL) {
+        perror("calloc");
+        return 1;
+    }
+
+    void* (*thread_fn)(void*) = mix_count == 0 ? storm_thread : framed ? framed_thread : command_thread;
+    double start = now_sec();
+    deadline = start + duration;
+    int running = 0;
+    for (int i = 0; i < threads; i++) {
+        workers[i].count = count / threads + (i < count % threads);
+        workers[i].seed = (unsigned int)i * 2654435761u + 1;
+        if (pthread_create(&tids[i], NULL, thread_fn, &workers[i]) != 0) {
+            perror("pthread_create");
+            break;
+        }
+        running++;
+    }
+    int completed = 0;
+    int failed = 0;
+    uint64_t bytes = 0;
+    for (int i = 0; i < running; i++) {
+        pthread_join(tids[i], NULL);
+        completed += workers[i].completed;
+        failed += workers[i].failed;
+        bytes += workers[i].bytes;
+    }
+    double elapsed = now_sec() - start;
+
+    if (mix_count == 0) {
+        printf("threads %d  connections %d  failed %d  time %.3f s  %.0f conn/s\n",
+               running, completed, failed, elapsed, completed / elapsed);
+    } else {
+        printf("threads %d  commands %d  failed %d  time %.3f s  %.0f cmd/s  %.2f MB/s\n",
+               running, completed, failed, elapsed, completed / elapsed, (double)bytes / elapsed / 1e6);
+
+        static Histogram all;
+        printf("  latency (us)                      count      mean       p50       p99     p99.9       max\n");
+        for (int e = 0; e < mix_count; e++) {
+            static Histogram merged;
+            memset(&merged, 0, sizeof(merged));
+            for (int i = 0; i < running; i++) {
+                hist_merge(&merged, &workers[i].latency[e]);
+            }
+            hist_merge(&all, &merged);
+            print_latency(mix[e].command, &merged);
+        }
+        if (mix_count > 1) {
+            print_latency("(all)", &all);
+        }
+    }
+    free(workers);
+    free(tids);
+    return failed == 0 ? 0 : 1;
+}
@@ -17,6 +17,7 @@
 /*
  * Standard library includes
  */
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -43,6 +44,75 @@
 #define BUFFER_SIZE 1024
 #define RESPONSE_END_MARKER "<END_OF_RESPONSE>"
 
+/*
+ * Framed protocol (optional)
+ *
+ * The text protocol above ends commands with a newline and responses with
+ * RESPONSE_END_MARKER. A client that wants binary-safe framing sends
+ * PROTOCOL_FRAMED_REQUEST as its first command; the server answers with
+ * PROTOCOL_FRAMED_REPLY as an ordinary text response and from then on both
+ * sides exchange frames. A server without framing runs the line as a shell
+ * command ("command not found"), so the client stays in text mode.
+ *
+ * Every frame starts with a FRAME_HEADER_SIZE byte header, big-endian:
+ *   u32 length      payload bytes following the header
+ *   u32 request_id  chosen by the client, echoed in each response frame
+ *   u8  type        FRAME_REQUEST, FRAME_DATA or FRAME_END
+ *   u8  status      FRAME_END only: one of FRAME_STATUS_*
+ *   u16 code        FRAME_END only: exit code of the command
+ * A request carries one command of at most FRAME_MAX_COMMAND bytes. Its
+ * response is any number of FRAME_DATA frames with raw command output,
+ * then one FRAME_END whose payload is a message for the user (timeout or
+ * error text), never command output.
+ */
+#define PROTOCOL_FRAMED_REQUEST "PROTOCOL FRAMED"
+#define PROTOCOL_FRAMED_REPLY "[SERVER] Switching to framed protocol\n"
+
+#define FRAME_HEADER_SIZE 12
+#define FRAME_MAX_COMMAND (BUFFER_SIZE - 1)
+
+#define FRAME_REQUEST 1
+#define FRAME_DATA 2
+#define FRAME_END 3
+
+#define FRAME_STATUS_OK 0           // command ran; code is its exit code
+#define FRAME_STATUS_TIMEOUT 1      // killed after COMMAND_TIMEOUT seconds
+#define FRAME_STATUS_ERROR 2        // could not run, or a malformed request
+#define FRAME_STATUS_CLOSING 3      // EXIT: the server closes the connection
+
+typedef struct {
+    uint32_t length;
+    uint32_t request_id;
+    uint8_t type;
+    uint8_t status;
+    uint16_t code;
+} FrameHeader;
+
+static inline void frame_encode(unsigned char out[FRAME_HEADER_SIZE], const FrameHeader* h) {
+    uint32_t length = htonl(h->length);
+    uint32_t request_id = htonl(h->request_id);
+    uint16_t code = htons(h->code);
+    memcpy(out, &length, 4);
+    memcpy(out + 4, &request_id, 4);
+    out[8] = h->type;
+    out[9] = h->status;
+    memcpy(out + 10, &code, 2);
+}
+
+static inline void frame_decode(const unsigned char in[FRAME_HEADER_SIZE], FrameHeader* h) {
+    uint32_t length;
+    uint32_t request_id;
+    uint16_t code;
+    memcpy(&length, in, 4);
+    memcpy(&request_id, in + 4, 4);
+    memcpy(&code, in + 10, 2);
+    h->length = ntohl(length);
+    h->request_id = ntohl(request_id);
+    h->type = in[8];
+    h->status = in[9];
+    h->code = ntohs(code);
+}
+
 /*
  * Server configuration constants
  */
@@ -55,7 +125,6 @@
 int setup_tcp_server(int port);
 void* handle_client_connection(void* socket_ptr);
 void execute_shell_command(char* command, int client_socket);
-void send_command_output(int client_socket, pid_t child_pid);
 void handle_user_command(char* command, int client_socket);
 void cleanup_and_exit(int sig);
 
@@ -19,6 +19,10 @@
 int tcp_socket = -1;
 volatile int client_running = 1;
 
+// Framed protocol state (--framed), see shell_server.h
+static int framed_protocol = 0;
+static uint32_t next_request_id = 1;
+
 /**
  * TODO:1 CONNECT TO SERVER 
  * 
@@ -136,6 +140,20 @@ void send_command(int socket, const char* command) {
     size_t total_sent = 0; //num of bytes sent successfully
     size_t command_len = strlen(command); //length of the command
     const char* data = command;     //points tot he command string
+    char frame[FRAME_HEADER_SIZE + FRAME_MAX_COMMAND];
+    
+    // On a framed connection the command goes out as one request frame,
+    // header and command together, with no newline terminator
+    if (framed_protocol) {
+        FrameHeader h = {(uint32_t)command_len, next_request_id++, FRAME_REQUEST, 0, 0};
+        if (command_len > FRAME_MAX_COMMAND) {
+            h.length = FRAME_MAX_COMMAND;
+        }
+        frame_encode((unsigned char*)frame, &h);
+        memcpy(frame + FRAME_HEADER_SIZE, command, h.length);
+        data = frame;
+        command_len = FRAME_HEADER_SIZE + h.length;
+    }
     
     // Step 2: Send complete command using loop for partial sends
     /* 
@@ -158,7 +176,7 @@ void send_command(int socket, const char* command) {
     
     // Step 3: Send newline terminator
     //server expects a newline after the command
-    if (send(socket, "\n", 1, 0) < 0) {
+    if (!framed_protocol && send(socket, "\n", 1, 0) < 0) {
         perror("Send newline failed");
         return;
     }
@@ -166,38 +184,173 @@ void send_command(int socket, const char* command) {
     /* END YOUR CODE */
 }
 
+// Streaming state for receive_response. Bytes that arrive after an end
+// marker belong to the next response and are kept here for the next call.
+#define MARKER_LEN (sizeof(RESPONSE_END_MARKER) - 1)
+static char pending_data[BUFFER_SIZE];
+static size_t pending_len = 0;
+static int skip_newline = 0;        // the newline after a marker has not arrived yet
+
+// While set, receive_response stores up to reply_capture_size bytes of the
+// response here instead of printing it (see negotiate_framed)
+static char* reply_capture = NULL;
+static size_t reply_capture_size = 0;
+static size_t reply_capture_len = 0;
+
+/**
+ * Longest proper prefix of RESPONSE_END_MARKER that is also a suffix of its
+ * first q bytes, for q = 0..MARKER_LEN (the KMP failure table). Built once.
+ */
+static const size_t* marker_fallback(void) {
+    static size_t fail[MARKER_LEN + 1];
+    static int built = 0;
+    if (!built) {
+        size_t k = 0;
+        fail[0] = 0;
+        fail[1] = 0;
+        for (size_t q = 1; q < MARKER_LEN; q++) {
+            while (k > 0 && RESPONSE_END_MARKER[q] != RESPONSE_END_MARKER[k]) {
+                k = fail[k];
+            }
+            if (RESPONSE_END_MARKER[q] == RESPONSE_END_MARKER[k]) {
+                k++;
+            }
+            fail[q + 1] = k;
+        }
+        built = 1;
+    }
+    return fail;
+}
+
+/**
+ * Print response bytes, or capture them while reply_capture is set
+ */
+static void emit_output(const char* data, size_t len) {
+    if (reply_capture == NULL) {
+        fwrite(data, 1, len, stdout);
+        return;
+    }
+    size_t room = reply_capture_size - reply_capture_len;
+    size_t n = len < room ? len : room;
+    memcpy(reply_capture + reply_capture_len, data, n);
+    reply_capture_len += n;
+}
+
+/**
+ * Print the bytes that are now known not to belong to the end marker
+ * The unprinted stream is the marker prefix held from earlier chunks
+ * (held_before bytes, equal to the start of RESPONSE_END_MARKER) followed by
+ * the scanned bytes of this chunk; everything but the last held_after bytes
+ * is written, straight from the marker literal and the receive buffer.
+ */
+static void emit_unmatched(size_t held_before, const char* data, size_t scanned, size_t held_after) {
+    size_t total = held_before + scanned - held_after;
+    size_t from_marker = total < held_before ? total : held_before;
+    emit_output(RESPONSE_END_MARKER, from_marker);
+    emit_output(data, total - from_marker);
+}
+
+/**
+ * Receive exactly len bytes
+ * Returns 0 on success, -1 if the server disconnected or recv failed.
+ */
+static int recv_exact(int socket, void* buf, size_t len) {
+    size_t got = 0;
+    while (got < len) {
+        ssize_t n = recv(socket, (char*)buf + got, len - got, 0);
+        if (n <= 0) {
+            if (n == 0) {
+                printf("[Client] Server disconnected\n");
+            } else {
+                perror("Receive failed");
+            }
+            client_running = 0;
+            return -1;
+        }
+        got += (size_t)n;
+    }
+    return 0;
+}
+
+/**
+ * Receive one framed response: print the FRAME_DATA payloads as they
+ * arrive, then the message and status of the FRAME_END frame
+ */
+static void receive_framed_response(int socket) {
+    char buffer[BUFFER_SIZE];
+    unsigned char header[FRAME_HEADER_SIZE];
+    FrameHeader h;
+
+    while (client_running) {
+        if (recv_exact(socket, header, sizeof(header)) < 0) {
+            return;
+        }
+        frame_decode(header, &h);
+        if (h.type != FRAME_DATA && h.type != FRAME_END) {
+            printf("[Client] Unexpected frame type %d, disconnecting\n", h.type);
+            client_running = 0;
+            return;
+        }
+        // DATA payloads are output, the END payload is a message; both are printed
+        size_t left = h.length;
+        while (left > 0) {
+            size_t chunk = left < sizeof(buffer) ? left : sizeof(buffer);
+            if (recv_exact(socket, buffer, chunk) < 0) {
+                return;
+            }
+            fwrite(buffer, 1, chunk, stdout);
+            left -= chunk;
+        }
+        fflush(stdout);
+        if (h.type == FRAME_END) {
+            if (h.status == FRAME_STATUS_OK && h.code != 0) {
+                printf("[Response] Exit code: %d\n", h.code);
+            }
+            return;
+        }
+    }
+}
+
+/**
+ * Ask the server to switch this connection to the framed protocol
+ * Sends PROTOCOL_FRAMED_REQUEST as a text command and reads the text reply
+ * through receive_response, up to its end marker however long it is, so
+ * nothing of it is left to be taken for a frame. Returns 1 if the server
+ * switched, 0 if it answered with anything else (a server without framing
+ * runs it as a shell command) and the connection stays in text mode.
+ */
+static int negotiate_framed(int socket) {
+    char reply[sizeof(PROTOCOL_FRAMED_REPLY)];  // one byte more tells a longer reply apart
+
+    send_command(socket, PROTOCOL_FRAMED_REQUEST);
+    reply_capture = reply;
+    reply_capture_size = sizeof(reply);
+    reply_capture_len = 0;
+    receive_response(socket);
+    reply_capture = NULL;
+    return client_running && reply_capture_len == sizeof(PROTOCOL_FRAMED_REPLY) - 1
+           && memcmp(reply, PROTOCOL_FRAMED_REPLY, reply_capture_len) == 0;
+}
+
 /**
  * TODO:3 RECEIVE AND DISPLAY SERVER RESPONSE
  * 
  * Implement the receive_response function to:
  * 1. Receive data from server using recv() in a loop
- * 2. Accumulate all received data in a buffer
- * 3. Continue receiving until RESPONSE_END_MARKER is found
- * 4. Remove the end marker from output before displaying
+ * 2. Scan each received chunk once for RESPONSE_END_MARKER, including a
+ *    marker split across two recv() calls
+ * 3. Display the data as it arrives, without the end marker
+ * 4. Keep bytes received after the marker for the next response
  * 5. Handle server disconnection gracefully
- * 6. Display the complete response to user
  * 
- * REQUIRED VARIABLES:
- * - char buffer[BUFFER_SIZE];
- * - char all_data[BUFFER_SIZE * 5] = {0};
- * - ssize_t bytes_received;
- * - int response_done = 0;
+ * The marker is matched with a KMP automaton, so the cost is linear in the
+ * response size and only the partially matched marker (never the whole
+ * response) is held back between chunks.
  * 
  * 🕵️ HINTS:
- * - Use recv() in a loop to get all response data
- * - Check for RESPONSE_END_MARKER string using strstr()
- * - Use strcat() to accumulate data in all_data buffer
  * - Check recv() return value: 0 = disconnection, <0 = error
- * - Remove RESPONSE_END_MARKER before displaying output
  * - Set client_running = 0 on disconnection
  * - Use sleep(1) for brief delay after processing
- * 
- * EXAMPLE FLOW:
- * 1. Loop while !response_done && client_running
- * 2. Receive data chunk with recv()
- * 3. Append to all_data buffer
- * 4. Check if RESPONSE_END_MARKER is present
- * 5. If found, remove marker and display result
  */
 void receive_response(int socket) {
     
@@ -205,62 +358,85 @@ void receive_response(int socket) {
     
     // Step 1: Declare required variables
     char buffer[BUFFER_SIZE]; //buffer to store the received data
-    char all_data[BUFFER_SIZE * 5] = {0}; //buffer to store the accumulated data
     ssize_t bytes_received; //number of bytes received
     int response_done = 0; // indicate if the response is complete
+    size_t matched = 0; // marker bytes matched so far, not yet printed
+    const size_t* fail = marker_fallback();
     
-    // Step 2: Main reception loop
-        /*
-          🕵️HINT:  
-            while (!response_done && client_running) {
-                Receive data chunk
-                Handle disconnection and errors
-                Null-terminate received data
-                Append to all_data buffer
-                Check for RESPONSE_END_MARKER
-            }
-        */
-    //continues until the response is complete  
+    // A framed response needs no scanning: frames carry their lengths
+    if (framed_protocol) {
+        receive_framed_response(socket);
+        sleep(1);
+        return;
+    }
+    
+    // Step 2: Main reception loop, continues until the response is complete
     while (!response_done && client_running) {
-        memset(buffer, 0, BUFFER_SIZE); //zero out the buffer to make sure no garbage values    
-        bytes_received = recv(socket, buffer, BUFFER_SIZE - 1, 0); //receive data from the server returns the number of bytes received
-        if (bytes_received <= 0) { //if the server disconnected or an error occurred
-            if (bytes_received == 0) { 
-                printf("[Client] Server disconnected\n");
-            } else { 
-                perror("Receive failed");
+        const char* data = buffer;
+        size_t len;
+        if (pending_len > 0) { // start with what followed the previous marker
+            data = pending_data;
+            len = pending_len;
+            pending_len = 0;
+        } else {
+            bytes_received = recv(socket, buffer, BUFFER_SIZE, 0); //receive data from the server returns the number of bytes received
+            if (bytes_received <= 0) { //if the server disconnected or an error occurred
+                emit_output(RESPONSE_END_MARKER, matched); // a partial marker was data after all
+                if (bytes_received == 0) { 
+                    printf("[Client] Server disconnected\n");
+                } else { 
+                    perror("Receive failed");
+                }
+                client_running = 0;
+                break; 
             }
-            client_running = 0;
-            break; 
+            len = (size_t)bytes_received;
         }
-        buffer[bytes_received] = '\0'; //null terminates the received data
-        strcat(all_data, buffer); //append the received data to the accumulated data
-        // Check for RESPONSE_END_MARKER if the response is complete
-        if (strstr(all_data, RESPONSE_END_MARKER) != NULL) {
-            response_done = 1;
-        } 
-    }
-    
-    // Step 3: Process complete response
-        /*
-          🕵️HINT:  
-            if (response_done) {
-                Find and remove RESPONSE_END_MARKER
-                Display the response
+
+        // the newline that terminates the previous marker line is not output
+        size_t start = 0;
+        if (skip_newline) {
+            skip_newline = 0;
+            start = data[0] == '\n';
+        }
+
+        // Step 3: Feed the new bytes through the marker matcher
+        size_t held_before = matched;
+        size_t i = start;
+        while (i < len) {
+            while (matched > 0 && data[i] != RESPONSE_END_MARKER[matched]) {
+                matched = fail[matched];
+            }
+            if (data[i] == RESPONSE_END_MARKER[matched]) {
+                matched++;
+            }
+            i++;
+            if (matched == MARKER_LEN) {
+                response_done = 1;
+                break;
             }
-        */
-        //display the response
-    if (response_done) {
-        char* marker_pos = strstr(all_data, RESPONSE_END_MARKER); //find the position of the response end marker
-        if (marker_pos != NULL) {
-            *marker_pos = '\0'; // remove the marker
         }
-        printf("%s", all_data); //display to user
+        emit_unmatched(held_before, data + start, i - start, matched);
+        fflush(stdout);
+
+        // Step 4: Keep whatever follows the marker for the next response
+        if (response_done) {
+            if (i == len) {
+                skip_newline = 1;
+            } else if (data[i] == '\n') {
+                i++;
+            }
+            memmove(pending_data, data + i, len - i);
+            pending_len = len - i;
+        }
     }
 
-    // Step 4: Brief delay before continuing
-    // delay to allow the server to process the response
-    sleep(1);
+    // Step 5: Brief delay before continuing
+    // delay to allow the server to process the response (not for a reply
+    // that is only captured)
+    if (reply_capture == NULL) {
+        sleep(1);
+    }
     
     /* END YOUR CODE */
 }
@@ -378,8 +554,18 @@ void print_welcome_banner() {
 /**
  * COMPLETE IMPLEMENTATION: Main client function
  */
-int main() {
+int main(int argc, char* argv[]) {
     char command[BUFFER_SIZE];
+    int want_framed = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--framed") == 0) {
+            want_framed = 1;
+        } else {
+            fprintf(stderr, "Usage: %s [--framed]\n", argv[0]);
+            return 1;
+        }
+    }
     
     // Display startup information
     print_welcome_banner();
@@ -400,6 +586,13 @@ int main() {
     printf("\n[Connection] Connected! Receiving welcome message...\n");
     receive_response(tcp_socket);
 
+    // Switch to length-prefixed frames if asked to and the server supports them
+    if (want_framed) {
+        framed_protocol = negotiate_framed(tcp_socket);
+        printf("[Connection] %s\n", framed_protocol ? "Using the framed protocol"
+                                                     : "Server does not support framing, using text mode");
+    }
+
     // Main command processing loop
     printf("\nReady for commands. Type 'EXIT' to quit.\n");
     while (client_running) {
@@ -12,12 +12,330 @@
 // Feature test macros 
 #define _POSIX_C_SOURCE 200809L
 #define _DEFAULT_SOURCE
+#define _GNU_SOURCE     // pipe2, accept4
 #include "shell_server.h"
+#include <poll.h>
+#include <netinet/tcp.h>
+#include <spawn.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <stdatomic.h>
+#include <stdarg.h>
+
+// Welcome line sent on connect, shared by every serving mode
+#define WELCOME_FORMAT "[SERVER] Hello %s:%d! Type 'HELP' for commands.\n" RESPONSE_END_MARKER "\n"
 
 // Global variables for cleanup - DO NOT MODIFY
 int tcp_server_socket = -1;
 volatile int server_running = 1;
 
+/**
+ * ASYNC LOGGING
+ *
+ * Every thread formats its log lines into a ring buffer of its own, and one
+ * drain thread writes whatever the rings hold to stdout with one writev. A
+ * log line costs a vsnprintf and a memcpy on the calling thread: no stdio
+ * lock shared by all threads, and no write() per line.
+ *
+ * Each ring has one producer (the owning thread) and one consumer (the
+ * drain thread), so head and tail are plain atomics. Rings are never freed:
+ * an exiting thread gives its ring back and the next new thread reuses it,
+ * so there are only as many rings as there were threads at once. If a ring
+ * is full the line is dropped and counted; a request never waits for the
+ * log.
+ *
+ * The lines of one thread stay in order; lines from different threads can
+ * be reordered by up to one drain interval. The drain thread writes every
+ * LOG_FLUSH_MS while there is output and sleeps when there is none, until
+ * the next line wakes it. cleanup_and_exit and exit() write out whatever is
+ * left, and from then on lines are written directly.
+ *
+ * --log-level selects the least severe level logged: error, warn, info
+ * (default) or debug, which adds the per-command spawn and exit lines.
+ */
+#define LOG_RING_SIZE (32 * 1024)       // bytes per thread, a power of two
+#define LOG_LINE_MAX 4096
+#define LOG_FLUSH_MS 5
+#define LOG_IDLE_MS 200
+#define LOG_DRAIN_IOV 64
+
+enum { LOG_ERROR, LOG_WARN, LOG_INFO, LOG_DEBUG };
+
+static const char* const log_level_names[] = {"error", "warn", "info", "debug"};
+
+typedef struct LogRing {
+    _Alignas(64) _Atomic size_t head;   // advanced by the owning thread
+    _Alignas(64) _Atomic size_t tail;   // advanced by the drain thread
+    _Atomic int owned;
+    struct LogRing* next;               // registry link, set before publishing
+    char data[LOG_RING_SIZE];
+} LogRing;
+
+static int log_level = LOG_INFO;
+static _Atomic(LogRing*) log_rings = NULL;
+static _Thread_local LogRing* log_ring = NULL;
+static pthread_key_t log_ring_key;
+static _Atomic int log_sync = 1;            // no drain thread (yet, or any more): write directly
+static _Atomic int log_idle = 0;            // drain thread is waiting for log_wake_cond
+static _Atomic uint64_t log_dropped = 0;
+static atomic_flag log_draining = ATOMIC_FLAG_INIT;
+static pthread_mutex_t log_wake_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t log_wake_cond = PTHREAD_COND_INITIALIZER;
+
+static void log_write_direct(const char* text, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(STDOUT_FILENO, text, len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return;
+        }
+        text += n;
+        len -= (size_t)n;
+    }
+}
+
+static void log_release_ring(void* ring) {
+    atomic_store_explicit(&((LogRing*)ring)->owned, 0, memory_order_release);
+}
+
+/**
+ * Give the calling thread a ring: a released one if there is one, else a
+ * new one added to the registry. Returns NULL if none can be allocated.
+ */
+static LogRing* log_claim_ring(void) {
+    LogRing* ring;
+    for (ring = atomic_load_explicit(&log_rings, memory_order_acquire); ring != NULL; ring = ring->next) {
+        int expected = 0;
+        if (atomic_compare_exchange_strong_explicit(&ring->owned, &expected, 1, memory_order_acquire,
+                                                    memory_order_relaxed)) {
+            break;
+        }
+    }
+    if (ring == NULL) {
+        ring = aligned_alloc(_Alignof(LogRing), sizeof(LogRing));
+        if (ring == NULL) {
+            return NULL;
+        }
+        atomic_init(&ring->head, 0);
+        atomic_init(&ring->tail, 0);
+        atomic_init(&ring->owned, 1);
+        ring->next = atomic_load_explicit(&log_rings, memory_order_relaxed);
+        while (!atomic_compare_exchange_weak_explicit(&log_rings, &ring->next, ring, memory_order_release,
+                                                      memory_order_relaxed)) {
+        }
+    }
+    pthread_setspecific(log_ring_key, ring);
+    return ring;
+}
+
+static int log_push(LogRing* ring, const char* line, size_t len) {
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (LOG_RING_SIZE - (head - tail) < len) {
+        return -1;
+    }
+    size_t at = head & (LOG_RING_SIZE - 1);
+    size_t first = LOG_RING_SIZE - at < len ? LOG_RING_SIZE - at : len;
+    memcpy(ring->data + at, line, first);
+    memcpy(ring->data, line + first, len - first);
+    atomic_store_explicit(&ring->head, head + len, memory_order_release);
+    return 0;
+}
+
+/**
+ * Log one line (format should end with a newline) if level is enabled
+ * errno is preserved, so a caller may log before reporting it.
+ */
+__attribute__((format(printf, 2, 3)))
+static void log_printf(int level, const char* format, ...) {
+    if (level > log_level) {
+        return;
+    }
+    int saved_errno = errno;
+    char line[LOG_LINE_MAX];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (n > 0) {
+        size_t len = (size_t)n < sizeof(line) ? (size_t)n : sizeof(line) - 1;
+        if (len < (size_t)n) {
+            line[len - 1] = '\n';
+        }
+        if (atomic_load_explicit(&log_sync, memory_order_relaxed)
+            || (log_ring == NULL && (log_ring = log_claim_ring()) == NULL)) {
+            log_write_direct(line, len);
+        } else if (log_push(log_ring, line, len) < 0) {
+            atomic_fetch_add_explicit(&log_dropped, 1, memory_order_relaxed);
+        }
+
+        // pairs with the fence in log_drainer: either it sees this line or we see it idle
+        atomic_thread_fence(memory_order_seq_cst);
+        if (atomic_load_explicit(&log_idle, memory_order_relaxed) && atomic_exchange(&log_idle, 0)) {
+            pthread_mutex_lock(&log_wake_lock);
+            pthread_cond_signal(&log_wake_cond);
+            pthread_mutex_unlock(&log_wake_lock);
+        }
+    }
+    errno = saved_errno;
+}
+
+static void log_writev(struct iovec* iov, int count) {
+    while (count > 0) {
+        ssize_t n = writev(STDOUT_FILENO, iov, count);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return;                 // stdout is gone; the lines are dropped
+        }
+        while (count > 0 && (size_t)n >= iov->iov_len) {
+            n -= (ssize_t)iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char*)iov->iov_base + n;
+            iov->iov_len -= (size_t)n;
+        }
+    }
+}
+
+/**
+ * Write out everything the rings hold, LOG_DRAIN_IOV / 2 rings per writev
+ * Returns the number of bytes taken from the rings.
+ */
+static size_t log_drain(void) {
+    struct iovec iov[LOG_DRAIN_IOV];
+    LogRing* drained[LOG_DRAIN_IOV / 2];
+    size_t heads[LOG_DRAIN_IOV / 2];
+    size_t total = 0;
+
+    while (atomic_flag_test_and_set_explicit(&log_draining, memory_order_acquire)) {
+        sched_yield();
+    }
+    LogRing* ring = atomic_load_explicit(&log_rings, memory_order_acquire);
+    while (ring != NULL) {
+        int nrings = 0;
+        int niov = 0;
+        for (; ring != NULL && nrings < LOG_DRAIN_IOV / 2; ring = ring->next) {
+            size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+            size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+            if (head == tail) {
+                continue;
+            }
+            size_t at = tail & (LOG_RING_SIZE - 1);
+            size_t len = head - tail;
+            size_t first = LOG_RING_SIZE - at < len ? LOG_RING_SIZE - at : len;
+            iov[niov++] = (struct iovec){.iov_base = ring->data + at, .iov_len = first};
+            if (first < len) {
+                iov[niov++] = (struct iovec){.iov_base = ring->data, .iov_len = len - first};
+            }
+            drained[nrings] = ring;
+            heads[nrings++] = head;
+            total += len;
+        }
+        log_writev(iov, niov);
+        for (int i = 0; i < nrings; i++) {
+            atomic_store_explicit(&drained[i]->tail, heads[i], memory_order_release);
+        }
+    }
+
+    uint64_t dropped = atomic_exchange_explicit(&log_dropped, 0, memory_order_relaxed);
+    if (dropped > 0) {
+        char note[96];
+        int n = snprintf(note, sizeof(note), "[Log] %llu lines dropped, the log could not keep up\n",
+                         (unsigned long long)dropped);
+        log_write_direct(note, (size_t)n);
+    }
+    atomic_flag_clear_explicit(&log_draining, memory_order_release);
+    return total;
+}
+
+static void* log_drainer(void* arg) {
+    (void)arg;
+    const struct timespec pause = {0, LOG_FLUSH_MS * 1000000L};
+    while (1) {
+        if (log_drain() > 0) {
+            nanosleep(&pause, NULL);        // let the next batch collect
+            continue;
+        }
+        atomic_store(&log_idle, 1);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (log_drain() > 0) {
+            atomic_store(&log_idle, 0);
+            continue;
+        }
+        pthread_mutex_lock(&log_wake_lock);
+        if (atomic_load(&log_idle)) {
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += LOG_IDLE_MS * 1000000L;
+            deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+            deadline.tv_nsec %= 1000000000L;
+            pthread_cond_timedwait(&log_wake_cond, &log_wake_lock, &deadline);
+        }
+        pthread_mutex_unlock(&log_wake_lock);
+        atomic_store(&log_idle, 0);
+    }
+    return NULL;
+}
+
+/**
+ * Write out what is buffered and switch to direct writes
+ * Runs from cleanup_and_exit and at exit(); signals are blocked meanwhile
+ * so a handler cannot interrupt the drain and then wait for it.
+ */
+static void log_flush(void) {
+    sigset_t all;
+    sigset_t old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    atomic_store(&log_sync, 1);
+    log_drain();
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+}
+
+static int log_level_from_name(const char* name) {
+    for (int i = 0; i < (int)(sizeof(log_level_names) / sizeof(log_level_names[0])); i++) {
+        if (strcmp(name, log_level_names[i]) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Start the drain thread; until then (or if it fails) lines are written
+ * directly. The drain thread blocks all signals, so cleanup_and_exit
+ * never runs on it.
+ */
+static void log_start(void) {
+    pthread_t drainer;
+    sigset_t all;
+    sigset_t old;
+    if (pthread_key_create(&log_ring_key, log_release_ring) != 0) {
+        return;
+    }
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    int rc = pthread_create(&drainer, NULL, log_drainer, NULL);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    if (rc != 0) {
+        perror("Failed to create log thread");
+        return;
+    }
+    pthread_detach(drainer);
+    atexit(log_flush);
+    atomic_store(&log_sync, 0);
+}
+
 /**
  * TODO:1 SETUP TCP SERVER SOCKET
  * 
@@ -66,8 +384,9 @@ int setup_tcp_server(int port) {
     struct sockaddr_in server_addr;
     int opt = 1;
     
-    // Step 1: Create TCP socket
-    server_socket = socket(AF_INET, SOCK_STREAM, 0);
+    // Step 1: Create TCP socket (close-on-exec, so command children,
+    // including background jobs, never hold the port)
+    server_socket = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
     if (server_socket < 0) {
         perror("Socket creation failed");
         return -1;
@@ -101,13 +420,802 @@ int setup_tcp_server(int port) {
     }
     
     // Step 6: Print success messages
-    printf("[Server] TCP server listening on %s:%d\n", SERVER_IP, SERVER_PORT);
-    printf("[Server] Ready to accept client connections...\n");
+    log_printf(LOG_INFO, "[Server] TCP server listening on %s:%d\n", SERVER_IP, SERVER_PORT);
+    log_printf(LOG_INFO, "[Server] Ready to accept client connections...\n");
     
     // This return statement should be replaced with your socket descriptor
     return server_socket;
 }
 
+/**
+ * SERVER METRICS
+ *
+ * Counters and latency histograms shared by every thread. Updates are
+ * relaxed atomic adds, so recording never takes a lock and never makes one
+ * thread wait for another; a reader may see a snapshot that is a few
+ * events apart between two counters, which is fine for monitoring.
+ *
+ * Histograms are HDR-style log-linear: values (microseconds) are bucketed
+ * by power of two, and each power of two is split into HIST_SUB_BUCKETS
+ * linear sub-buckets, so every bucket is within 1 / HIST_SUB_BUCKETS of its
+ * values (about 6%) from 1 us to hours at a fixed 8 KB per histogram.
+ *
+ * Reported with the STATS command, and every --stats-interval seconds in
+ * the server log.
+ */
+#define HIST_SUB_BITS 4
+#define HIST_SUB_BUCKETS (1 << HIST_SUB_BITS)
+#define HIST_BUCKETS ((64 - HIST_SUB_BITS + 1) * HIST_SUB_BUCKETS)
+#define STATS_TEXT_SIZE 2048
+
+typedef struct {
+    const char* name;
+    _Atomic uint64_t buckets[HIST_BUCKETS];
+    _Atomic uint64_t count;
+    _Atomic uint64_t sum;
+    _Atomic uint64_t max;
+} LatencyHistogram;
+
+/**
+ * Per-connection counters; commands of a pipelined client update them from
+ * several workers at once
+ */
+typedef struct {
+    _Atomic uint64_t commands;
+    _Atomic uint64_t bytes_sent;
+    uint64_t connected_ns;
+} ClientStats;
+
+static struct {
+    uint64_t start_ns;
+    _Atomic uint64_t connections_accepted;
+    _Atomic int64_t connections_active;
+    _Atomic uint64_t commands;
+    _Atomic uint64_t commands_timed_out;
+    _Atomic uint64_t commands_failed;       // could not be started
+    _Atomic uint64_t bytes_sent;
+    _Atomic uint64_t cache_hits;            // --cache-ttl: answered from the result cache
+    _Atomic uint64_t cache_misses;          // cacheable commands that were run
+    _Atomic uint64_t cache_stores;
+    _Atomic uint64_t cache_evictions;       // removed to stay within the memory bound
+    LatencyHistogram queue;                 // request received -> handler starts
+    LatencyHistogram spawn;                 // fork / posix_spawn call
+    LatencyHistogram run;                   // child started -> response sent
+    LatencyHistogram total;                 // request received -> response sent
+} stats = {
+    .queue = {.name = "queue"},
+    .spawn = {.name = "spawn"},
+    .run = {.name = "run"},
+    .total = {.name = "total"},
+};
+
+static int stats_interval = 0;              // seconds between dumps, 0 = off
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void stats_add(_Atomic uint64_t* counter, uint64_t n) {
+    atomic_fetch_add_explicit(counter, n, memory_order_relaxed);
+}
+
+static int hist_index(uint64_t us) {
+    if (us < HIST_SUB_BUCKETS) {
+        return (int)us;
+    }
+    int exponent = 63 - __builtin_clzll(us);
+    int sub = (int)(us >> (exponent - HIST_SUB_BITS)) & (HIST_SUB_BUCKETS - 1);
+    return (exponent - HIST_SUB_BITS + 1) * HIST_SUB_BUCKETS + sub;
+}
+
+/**
+ * Largest value that falls in bucket index (what percentiles report)
+ */
+static uint64_t hist_bucket_top(int index) {
+    if (index < HIST_SUB_BUCKETS) {
+        return (uint64_t)index;
+    }
+    int shift = index / HIST_SUB_BUCKETS - 1;
+    uint64_t sub = (uint64_t)(index % HIST_SUB_BUCKETS);
+    return ((HIST_SUB_BUCKETS + sub + 1) << shift) - 1;
+}
+
+/**
+ * Record the time since start_ns
+ */
+static void hist_record(LatencyHistogram* h, uint64_t start_ns) {
+    uint64_t us = (now_ns() - start_ns) / 1000;
+    stats_add(&h->buckets[hist_index(us)], 1);
+    stats_add(&h->count, 1);
+    stats_add(&h->sum, us);
+    uint64_t max = atomic_load_explicit(&h->max, memory_order_relaxed);
+    while (us > max && !atomic_compare_exchange_weak_explicit(&h->max, &max, us, memory_order_relaxed,
+                                                             memory_order_relaxed)) {
+    }
+}
+
+/**
+ * Value at or below which the given share (0..1) of the recorded values lie,
+ * never above the largest value recorded
+ */
+static uint64_t hist_percentile(LatencyHistogram* h, uint64_t count, double share) {
+    uint64_t rank = (uint64_t)(share * (double)count + 0.5);
+    uint64_t max = atomic_load_explicit(&h->max, memory_order_relaxed);
+    uint64_t seen = 0;
+    if (rank == 0) {
+        rank = 1;
+    }
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        seen += atomic_load_explicit(&h->buckets[i], memory_order_relaxed);
+        if (seen >= rank) {
+            return hist_bucket_top(i) < max ? hist_bucket_top(i) : max;
+        }
+    }
+    return max;
+}
+
+static int format_histogram(char* out, size_t size, LatencyHistogram* h) {
+    uint64_t count = atomic_load_explicit(&h->count, memory_order_relaxed);
+    uint64_t sum = atomic_load_explicit(&h->sum, memory_order_relaxed);
+    if (count == 0) {
+        return snprintf(out, size, "  %-6s %10d\n", h->name, 0);
+    }
+    return snprintf(out, size, "  %-6s %10llu %9llu %9llu %9llu %9llu %9llu %9llu\n", h->name,
+                    (unsigned long long)count, (unsigned long long)(sum / count),
+                    (unsigned long long)hist_percentile(h, count, 0.50),
+                    (unsigned long long)hist_percentile(h, count, 0.90),
+                    (unsigned long long)hist_percentile(h, count, 0.99),
+                    (unsigned long long)hist_percentile(h, count, 0.999),
+                    (unsigned long long)atomic_load_explicit(&h->max, memory_order_relaxed));
+}
+
+/**
+ * Render the server-wide metrics, and the client's own if client is not NULL
+ * Returns the length written (truncated to size - 1).
+ */
+static size_t format_stats(char* out, size_t size, const ClientStats* client) {
+    uint64_t now = now_ns();
+    double uptime = (double)(now - stats.start_ns) / 1e9;
+    uint64_t accepted = atomic_load_explicit(&stats.connections_accepted, memory_order_relaxed);
+    uint64_t commands = atomic_load_explicit(&stats.commands, memory_order_relaxed);
+    size_t len = 0;
+
+#define STATS_APPEND(...)                                               \
+    do {                                                                \
+        if (len < size) {                                               \
+            int n = snprintf(out + len, size - len, __VA_ARGS__);       \
+            len += n > 0 ? (size_t)n : 0;                               \
+        }                                                               \
+    } while (0)
+
+    STATS_APPEND("Server uptime: %.1f s\n", uptime);
+    STATS_APPEND("Connections: %llu accepted (%.1f/s), %lld active\n", (unsigned long long)accepted,
+                 (double)accepted / uptime,
+                 (long long)atomic_load_explicit(&stats.connections_active, memory_order_relaxed));
+    STATS_APPEND("Commands: %llu (%.1f/s), %llu timed out, %llu failed to start\n", (unsigned long long)commands,
+                 (double)commands / uptime,
+                 (unsigned long long)atomic_load_explicit(&stats.commands_timed_out, memory_order_relaxed),
+                 (unsigned long long)atomic_load_explicit(&stats.commands_failed, memory_order_relaxed));
+    STATS_APPEND("Bytes sent: %llu\n",
+                 (unsigned long long)atomic_load_explicit(&stats.bytes_sent, memory_order_relaxed));
+    uint64_t hits = atomic_load_explicit(&stats.cache_hits, memory_order_relaxed);
+    uint64_t misses = atomic_load_explicit(&stats.cache_misses, memory_order_relaxed);
+    if (hits + misses > 0) {
+        STATS_APPEND("Result cache: %llu hits, %llu misses (%.1f%% hit), %llu stored, %llu evicted\n",
+                     (unsigned long long)hits, (unsigned long long)misses,
+                     100.0 * (double)hits / (double)(hits + misses),
+                     (unsigned long long)atomic_load_explicit(&stats.cache_stores, memory_order_relaxed),
+                     (unsigned long long)atomic_load_explicit(&stats.cache_evictions, memory_order_relaxed));
+    }
+    STATS_APPEND("Latency (us)    count      mean       p50       p90       p99     p99.9       max\n");
+    LatencyHistogram* hists[] = {&stats.queue, &stats.spawn, &stats.run, &stats.total};
+    for (size_t i = 0; i < sizeof(hists) / sizeof(hists[0]); i++) {
+        if (len < size) {
+            int n = format_histogram(out + len, size - len, hists[i]);
+            len += n > 0 ? (size_t)n : 0;
+        }
+    }
+    if (client != NULL) {
+        STATS_APPEND("This connection: %llu commands, %llu bytes sent, connected %.1f s\n",
+                     (unsigned long long)atomic_load_explicit(&client->commands, memory_order_relaxed),
+                     (unsigned long long)atomic_load_explicit(&client->bytes_sent, memory_order_relaxed),
+                     (double)(now - client->connected_ns) / 1e9);
+    }
+#undef STATS_APPEND
+    return len < size ? len : size - 1;
+}
+
+static void client_stats_open(ClientStats* client) {
+    atomic_init(&client->commands, 0);
+    atomic_init(&client->bytes_sent, 0);
+    client->connected_ns = now_ns();
+    stats_add(&stats.connections_accepted, 1);
+    atomic_fetch_add_explicit(&stats.connections_active, 1, memory_order_relaxed);
+}
+
+static void client_stats_close(void) {
+    atomic_fetch_sub_explicit(&stats.connections_active, 1, memory_order_relaxed);
+}
+
+/**
+ * Dump the metrics to the log every stats_interval seconds
+ */
+static void* stats_dumper(void* arg) {
+    (void)arg;
+    char text[STATS_TEXT_SIZE];
+    uint64_t last_accepted = 0;
+    uint64_t last_commands = 0;
+    while (1) {
+        sleep((unsigned int)stats_interval);
+        uint64_t accepted = atomic_load_explicit(&stats.connections_accepted, memory_order_relaxed);
+        uint64_t commands = atomic_load_explicit(&stats.commands, memory_order_relaxed);
+        format_stats(text, sizeof(text), NULL);
+        log_printf(LOG_INFO, "[Stats] last %d s: %.1f connections/s, %.1f commands/s\n%s", stats_interval,
+                   (double)(accepted - last_accepted) / stats_interval,
+                   (double)(commands - last_commands) / stats_interval, text);
+        last_accepted = accepted;
+        last_commands = commands;
+    }
+    return NULL;
+}
+
+/**
+ * RESPONSE ASSEMBLY
+ *
+ * Command output is read straight into a Response buffer and sent in large
+ * pieces: output that arrives within RESPONSE_FLUSH_DELAY_MS of the last
+ * read is coalesced, and the buffer is flushed when it fills or the
+ * command goes quiet. The end marker (or the timeout message) is attached
+ * to the last piece with writev, so a short response is one syscall.
+ * Since responses are assembled here, client sockets use TCP_NODELAY and
+ * Nagle's algorithm no longer holds back the final piece.
+ *
+ * Responses that never change are built once, at compile time, with their
+ * lengths known, instead of being formatted with snprintf per request.
+ *
+ * A Reply names where a response goes and how it is framed: on a text
+ * connection the end of a response is RESPONSE_END_MARKER, on a framed one
+ * output goes out as FRAME_DATA frames and the response ends with a
+ * FRAME_END frame carrying the status (see shell_server.h).
+ */
+#define RESPONSE_BUFFER_SIZE (64 * 1024)
+#define RESPONSE_FLUSH_DELAY_MS 2
+
+#define STRINGIFY(x) #x
+#define TO_STRING(x) STRINGIFY(x)
+
+static const char END_RESPONSE[] = RESPONSE_END_MARKER "\n";
+static const char GOODBYE_TEXT[] = "Goodbye! Connection closing...\n";
+static const char TIMEOUT_TEXT[] = "Command Timeout (exceeded " TO_STRING(COMMAND_TIMEOUT) " seconds)\n";
+static const char FRAMED_TEXT[] = PROTOCOL_FRAMED_REPLY;
+static const char HELP_TEXT[] =
+    "Available Commands:\n"
+    "  Shell Commands:\n"
+    "  ls, pwd, date, echo, sleep, cat, etc. - Any valid shell command\n"
+    "  ./program - Execute custom programs\n"
+    "Client Commands:\n"
+    "  HELP - Show available commands\n"
+    "  STATS - Show server metrics\n"
+    "  EXIT - Disconnect and quit client\n"
+    "Examples:\n"
+    "  ls -la\n"
+    "  pwd\n"
+    "  sleep 5\n"
+    "  echo 'Hello World'\n"
+    "  cat /etc/hostname\n";
+
+typedef struct {
+    int client_socket;
+    int framed;                         // connection switched to the framed protocol
+    uint32_t request_id;                // echoed in every frame of the response
+    pthread_mutex_t* write_lock;        // held per writev when commands of one client run at once, or NULL
+    ClientStats* client;                // per-connection metrics, or NULL
+    uint64_t received_ns;               // when the request was taken from the input
+    pid_t command_pid;                  // command still running while its output is written, or 0
+    uint64_t command_deadline_ns;       // now_ns() time at which command_pid is killed
+} Reply;
+
+typedef struct {
+    Reply to;
+    int failed;                         // client went away: output is dropped
+    size_t flushed;                     // output bytes already passed on
+    size_t len;                         // bytes waiting in data
+    char data[RESPONSE_BUFFER_SIZE];
+} Response;
+
+#define WRITE_STALL_NS ((uint64_t)COMMAND_TIMEOUT * 1000000000u)
+
+/**
+ * Write every iovec, retrying on partial writes
+ * The socket is waited on until writable, but a client that takes no bytes
+ * for WRITE_STALL_NS is given up on, so it cannot hold the thread. If the
+ * command writing its output (command > 0) reaches its deadline meanwhile,
+ * it is killed on time; the caller reaps it. Returns 0 on success, -1 if
+ * the client went away (errno ETIMEDOUT: it stopped reading).
+ */
+static int writev_all(int client_socket, struct iovec* iov, int iovcnt, pid_t command, uint64_t command_deadline_ns) {
+    uint64_t stall_ns = now_ns() + WRITE_STALL_NS;
+    while (iovcnt > 0) {
+        struct msghdr msg = {0};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = (size_t)iovcnt;
+        ssize_t sent = sendmsg(client_socket, &msg, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                uint64_t now = now_ns();
+                uint64_t wake_ns = stall_ns;
+                if (command > 0 && now >= command_deadline_ns) {
+                    kill(command, SIGKILL);
+                    command = 0;
+                } else if (command > 0 && command_deadline_ns < wake_ns) {
+                    wake_ns = command_deadline_ns;
+                }
+                struct pollfd pfd = {client_socket, POLLOUT, 0};
+                if (now >= stall_ns) {
+                    errno = ETIMEDOUT;
+                    return -1;
+                }
+                poll(&pfd, 1, (int)((wake_ns - now + 999999) / 1000000));
+                continue;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        stall_ns = now_ns() + WRITE_STALL_NS;
+        while (iovcnt > 0 && (size_t)sent >= iov->iov_len) {
+            sent -= (ssize_t)iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = (char*)iov->iov_base + sent;
+            iov->iov_len -= (size_t)sent;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Write one piece of a response; pieces of concurrent responses on the
+ * same connection never interleave
+ * A client that stopped reading is dropped: the socket is shut down, so
+ * later writes fail at once and the connection's reader sees EOF and
+ * closes it.
+ */
+static int reply_writev(const Reply* to, struct iovec* iov, int iovcnt) {
+    uint64_t bytes = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        bytes += iov[i].iov_len;        // writev_all advances iov as it goes
+    }
+    if (to->write_lock != NULL) {
+        pthread_mutex_lock(to->write_lock);
+    }
+    int result = writev_all(to->client_socket, iov, iovcnt, to->command_pid, to->command_deadline_ns);
+    if (result < 0 && errno == ETIMEDOUT) {
+        log_printf(LOG_WARN, "[Thread %lu] Client on socket %d stopped reading, dropping it\n",
+                   (unsigned long)pthread_self(), to->client_socket);
+        shutdown(to->client_socket, SHUT_RDWR);
+    }
+    if (to->write_lock != NULL) {
+        pthread_mutex_unlock(to->write_lock);
+    }
+    if (result == 0) {
+        stats_add(&stats.bytes_sent, bytes);
+        if (to->client != NULL) {
+            stats_add(&to->client->bytes_sent, bytes);
+        }
+    }
+    return result;
+}
+
+static void frame_header(unsigned char* out, const Reply* to, uint8_t type, uint8_t status, int code, size_t length) {
+    FrameHeader h = {(uint32_t)length, to->request_id, type, status, (uint16_t)code};
+    frame_encode(out, &h);
+}
+
+/**
+ * Send output that is not the end of the response
+ * Returns 0 on success, -1 if the client went away.
+ */
+static int reply_output(const Reply* to, const char* output, size_t len) {
+    unsigned char header[FRAME_HEADER_SIZE];
+    struct iovec iov[2] = {{header, sizeof(header)}, {(void*)output, len}};
+    if (!to->framed) {
+        return reply_writev(to, iov + 1, 1);
+    }
+    frame_header(header, to, FRAME_DATA, 0, 0, len);
+    return reply_writev(to, iov, 2);
+}
+
+/**
+ * Send the end of a response in one writev: the last output, then the status
+ * Text protocol: output, message and RESPONSE_END_MARKER. Framed protocol:
+ * a FRAME_DATA frame with the output (if any), then a FRAME_END frame with
+ * status and code whose payload is the message. Returns 0 on success, -1 if
+ * the client went away.
+ */
+static int reply_end(const Reply* to, const char* output, size_t output_len, int status, int code,
+                     const char* message, size_t message_len) {
+    unsigned char data_header[FRAME_HEADER_SIZE];
+    unsigned char end_header[FRAME_HEADER_SIZE];
+    struct iovec iov[4];
+    int iovcnt = 0;
+
+    if (to->framed && output_len > 0) {
+        frame_header(data_header, to, FRAME_DATA, 0, 0, output_len);
+        iov[iovcnt++] = (struct iovec){data_header, sizeof(data_header)};
+    }
+    if (output_len > 0) {
+        iov[iovcnt++] = (struct iovec){(void*)output, output_len};
+    }
+    if (to->framed) {
+        frame_header(end_header, to, FRAME_END, (uint8_t)status, code, message_len);
+        iov[iovcnt++] = (struct iovec){end_header, sizeof(end_header)};
+    }
+    if (message_len > 0) {
+        iov[iovcnt++] = (struct iovec){(void*)message, message_len};
+    }
+    if (!to->framed) {
+        iov[iovcnt++] = (struct iovec){(void*)END_RESPONSE, sizeof(END_RESPONSE) - 1};
+    }
+    return reply_writev(to, iov, iovcnt);
+}
+
+static void response_init(Response* r, const Reply* to) {
+    r->to = *to;
+    r->failed = 0;
+    r->flushed = 0;
+    r->len = 0;
+}
+
+static void response_flush(Response* r) {
+    if (!r->failed && r->len > 0 && reply_output(&r->to, r->data, r->len) < 0) {
+        r->failed = 1;
+    }
+    r->flushed += r->len;
+    r->len = 0;
+}
+
+/**
+ * Send the buffered output and end the response (see reply_end)
+ */
+static void response_end(Response* r, int status, int code, const char* message, size_t message_len) {
+    if (!r->failed && reply_end(&r->to, r->data, r->len, status, code, message, message_len) < 0) {
+        r->failed = 1;
+    }
+    r->len = 0;
+}
+
+/**
+ * Read from fd into the free space of the buffer, flushing it first if full
+ * Returns what read() returned.
+ */
+static ssize_t response_read(Response* r, int fd, size_t max) {
+    if (r->len == sizeof(r->data)) {
+        response_flush(r);
+    }
+    size_t room = sizeof(r->data) - r->len;
+    ssize_t n = read(fd, r->data + r->len, max < room ? max : room);
+    if (n > 0) {
+        r->len += (size_t)n;
+    }
+    return n;
+}
+
+/**
+ * REQUEST PARSING
+ *
+ * Received bytes are appended to a RequestBuffer and complete requests are
+ * taken from its front: a line on a text connection, a FRAME_REQUEST frame
+ * on a framed one. A command split over several recv calls, or several
+ * commands in one, therefore come out whole and one at a time, and bytes
+ * that follow the protocol switch are parsed as frames.
+ */
+typedef struct {
+    char data[FRAME_HEADER_SIZE + FRAME_MAX_COMMAND];
+    size_t len;
+    int eof;                            // recv returned 0: bytes left without a newline form the last line
+    int discarding;                     // rest of an overlong line: dropped through its newline
+} RequestBuffer;
+
+static void request_consume(RequestBuffer* in, size_t consumed) {
+    in->len -= consumed;
+    memmove(in->data, in->data + consumed, in->len);
+}
+
+/**
+ * Take the next line into command (BUFFER_SIZE bytes), without "\r\n"
+ * A line that does not fit is not run in pieces: it is dropped through its
+ * newline, which may arrive later. Returns 1 if there was a line (possibly
+ * empty), 0 if more input is needed, -1 if the line was too long.
+ */
+static int request_take_line(RequestBuffer* in, char* command) {
+    char* newline = memchr(in->data, '\n', in->len);
+    if (in->discarding) {
+        if (newline == NULL) {
+            in->len = 0;
+            return 0;
+        }
+        in->discarding = 0;
+        request_consume(in, (size_t)(newline - in->data) + 1);
+        newline = memchr(in->data, '\n', in->len);
+    }
+
+    size_t line_len;
+    size_t consumed;
+    if (newline != NULL) {
+        line_len = (size_t)(newline - in->data);
+        consumed = line_len + 1;
+    } else if (in->len > BUFFER_SIZE || (in->eof && in->len > 0)) {
+        // more than fits even without a "\r", or the last bytes before EOF
+        line_len = in->len;
+        consumed = in->len;
+        in->discarding = !in->eof;
+    } else {
+        return 0;
+    }
+    if (line_len > 0 && in->data[line_len - 1] == '\r') {
+        line_len--;
+    }
+    if (line_len > BUFFER_SIZE - 1) {
+        request_consume(in, consumed);
+        return -1;
+    }
+    in->discarding = 0;
+    memcpy(command, in->data, line_len);
+    command[line_len] = '\0';
+    request_consume(in, consumed);
+
+    char* carriage = strchr(command, '\r');
+    if (carriage) *carriage = '\0';
+    return 1;
+}
+
+/**
+ * Take the next request frame into command (BUFFER_SIZE bytes)
+ * Sets *request_id, also for a malformed frame so the error can be
+ * answered. Returns 1 if there was a frame, 0 if more input is needed,
+ * -1 if the frame is malformed.
+ */
+static int request_take_frame(RequestBuffer* in, char* command, uint32_t* request_id) {
+    FrameHeader h;
+    if (in->len < FRAME_HEADER_SIZE) {
+        return 0;
+    }
+    frame_decode((const unsigned char*)in->data, &h);
+    *request_id = h.request_id;
+    if (h.type != FRAME_REQUEST || h.length > FRAME_MAX_COMMAND) {
+        return -1;
+    }
+    if (in->len < FRAME_HEADER_SIZE + h.length) {
+        return 0;
+    }
+    memcpy(command, in->data + FRAME_HEADER_SIZE, h.length);
+    command[h.length] = '\0';
+    request_consume(in, FRAME_HEADER_SIZE + h.length);
+    return 1;
+}
+
+/**
+ * Take the next request in the connection's protocol (see above)
+ */
+static int request_take(RequestBuffer* in, Reply* to, char* command) {
+    return to->framed ? request_take_frame(in, command, &to->request_id) : request_take_line(in, command);
+}
+
+/**
+ * Answer a request request_take could not parse: a malformed frame, or a
+ * text line too long for the command buffer
+ */
+static void reply_malformed(const Reply* to) {
+    static const char malformed[] = "Malformed request frame\n";
+    static const char too_long[] = "Command too long, line discarded\n";
+    if (to->framed) {
+        reply_end(to, NULL, 0, FRAME_STATUS_ERROR, 0, malformed, sizeof(malformed) - 1);
+    } else {
+        reply_end(to, NULL, 0, FRAME_STATUS_ERROR, 0, too_long, sizeof(too_long) - 1);
+    }
+}
+
+// Defined with TODO 4 below
+static int send_command_output(Response* response, int output_fd, int pidfd, const struct timespec* deadline);
+
+// Defined with TODO 5 below
+static int handle_request(const char* command, Reply* to);
+
+/**
+ * PIPELINED REQUESTS
+ *
+ * A client may send requests without waiting for the responses. On a text
+ * connection they still run one at a time, in order, since text responses
+ * carry nothing that tells them apart. On a framed connection each response
+ * frame carries its request id, so up to pipeline_depth commands of one
+ * client run at once on the shared command workers. Their frames go out in
+ * completion order; the connection's write lock keeps every writev whole.
+ *
+ * EXIT (and a malformed frame, which ends the connection) waits until the
+ * client's running commands have answered, so nothing is cut off by the
+ * close.
+ */
+#define PIPELINE_DEFAULT_DEPTH 8
+#define PIPELINE_MAX_DEPTH 64
+
+typedef struct CommandJob {
+    Reply to;                               // connection, protocol and request id
+    char command[BUFFER_SIZE];              // empty for an empty framed request
+    int malformed;                          // answer FRAME_STATUS_ERROR instead of running (see reply_malformed)
+    void (*done)(struct CommandJob* job);   // called by the worker once answered
+    void* owner;                            // connection state used by done
+    struct CommandJob* next;                // link in job_list or done_list
+} CommandJob;
+
+/**
+ * Intrusive FIFO of jobs. A job is in at most one list, so pushing never
+ * allocates and never blocks the event loop.
+ */
+typedef struct {
+    CommandJob* head;
+    CommandJob* tail;
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+} JobList;
+
+static JobList job_list = {NULL, NULL, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER};
+static int pipeline_depth = PIPELINE_DEFAULT_DEPTH;
+static int command_workers = 0;             // pool size, set in main
+static int command_workers_started = 0;
+static pthread_once_t command_workers_once = PTHREAD_ONCE_INIT;
+
+static void job_list_push(JobList* list, CommandJob* job) {
+    job->next = NULL;
+    pthread_mutex_lock(&list->lock);
+    if (list->tail != NULL) {
+        list->tail->next = job;
+    } else {
+        list->head = job;
+    }
+    list->tail = job;
+    pthread_cond_signal(&list->ready);
+    pthread_mutex_unlock(&list->lock);
+}
+
+/**
+ * Remove the first job, blocking while the list is empty
+ */
+static CommandJob* job_list_pop(JobList* list) {
+    pthread_mutex_lock(&list->lock);
+    while (list->head == NULL) {
+        pthread_cond_wait(&list->ready, &list->lock);
+    }
+    CommandJob* job = list->head;
+    list->head = job->next;
+    if (list->head == NULL) {
+        list->tail = NULL;
+    }
+    pthread_mutex_unlock(&list->lock);
+    return job;
+}
+
+/**
+ * Detach the whole list without blocking; returns its first job
+ */
+static CommandJob* job_list_take_all(JobList* list) {
+    pthread_mutex_lock(&list->lock);
+    CommandJob* job = list->head;
+    list->head = NULL;
+    list->tail = NULL;
+    pthread_mutex_unlock(&list->lock);
+    return job;
+}
+
+static void* command_worker(void* arg) {
+    (void)arg;
+    while (1) {
+        CommandJob* job = job_list_pop(&job_list);
+        if (job->malformed) {
+            reply_malformed(&job->to);
+        } else if (job->command[0] == '\0') {
+            reply_end(&job->to, NULL, 0, FRAME_STATUS_OK, 0, NULL, 0);   // empty framed request
+        } else {
+            handle_request(job->command, &job->to);
+        }
+        job->done(job);
+    }
+    return NULL;
+}
+
+/**
+ * Start the command workers, once (event loop start, or the first
+ * pipelined request in the threaded modes)
+ */
+static void start_command_workers(void) {
+    for (int i = 0; i < command_workers; i++) {
+        pthread_t worker;
+        if (pthread_create(&worker, NULL, command_worker, NULL) != 0) {
+            perror("Failed to create command worker");
+            break;
+        }
+        pthread_detach(worker);
+        command_workers_started++;
+    }
+    log_printf(LOG_INFO, "[Thread %lu] Started %d command workers\n", (unsigned long)pthread_self(), command_workers_started);
+}
+
+/**
+ * Commands of one threaded-mode connection that run on the command workers
+ */
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t finished;                // signalled when a command has answered
+    int inflight;
+    pthread_mutex_t write_lock;
+} ClientPipeline;
+
+static void pipeline_init(ClientPipeline* p) {
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->finished, NULL);
+    pthread_mutex_init(&p->write_lock, NULL);
+    p->inflight = 0;
+}
+
+static void pipeline_job_done(CommandJob* job) {
+    ClientPipeline* p = (ClientPipeline*)job->owner;
+    free(job);
+    pthread_mutex_lock(&p->lock);
+    p->inflight--;
+    pthread_cond_signal(&p->finished);
+    pthread_mutex_unlock(&p->lock);
+}
+
+/**
+ * Queue a framed request for the command workers, first waiting while the
+ * client already has pipeline_depth commands running
+ * Returns -1 if it could not be queued; the caller then runs it itself.
+ */
+static int pipeline_submit(ClientPipeline* p, const Reply* to, const char* command) {
+    pthread_once(&command_workers_once, start_command_workers);
+    CommandJob* job = malloc(sizeof(CommandJob));
+    if (job == NULL || command_workers_started == 0) {
+        free(job);
+        return -1;
+    }
+    job->to = *to;
+    snprintf(job->command, sizeof(job->command), "%s", command);
+    job->malformed = 0;
+    job->done = pipeline_job_done;
+    job->owner = p;
+
+    pthread_mutex_lock(&p->lock);
+    while (p->inflight >= pipeline_depth) {
+        pthread_cond_wait(&p->finished, &p->lock);
+    }
+    p->inflight++;
+    pthread_mutex_unlock(&p->lock);
+    job_list_push(&job_list, job);
+    return 0;
+}
+
+/**
+ * Wait until every queued command of the connection has answered
+ */
+static void pipeline_wait_idle(ClientPipeline* p) {
+    pthread_mutex_lock(&p->lock);
+    while (p->inflight > 0) {
+        pthread_cond_wait(&p->finished, &p->lock);
+    }
+    pthread_mutex_unlock(&p->lock);
+}
+
+static void pipeline_destroy(ClientPipeline* p) {
+    pthread_mutex_destroy(&p->lock);
+    pthread_cond_destroy(&p->finished);
+    pthread_mutex_destroy(&p->write_lock);
+}
+
 /**
  * TODO 2: HANDLE CLIENT CONNECTION
  * 
@@ -151,13 +1259,11 @@ int setup_tcp_server(int port) {
  * [Thread 140234567890124] Command from 127.0.0.1:54321: 'ls -la'
  * [Thread 140234567890124] Client 127.0.0.1:54321 disconnected gracefully
  */
-void* handle_client_connection(void* socket_ptr) {
+static void serve_client(int client_socket) {
     
     /* YOUR CODE HERE - Implement client connection handling */
     
-    // Step 1: Extract client socket and free memory
-    int client_socket = *(int*)socket_ptr;
-    free(socket_ptr);
+    // Step 1: The socket was extracted by the caller (see handle_client_connection)
     
     // Step 2: Declare required variables
     char buffer[BUFFER_SIZE];
@@ -170,13 +1276,17 @@ void* handle_client_connection(void* socket_ptr) {
     if (getpeername(client_socket, (struct sockaddr*)&client_addr, &addr_len) == 0) {
         inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, INET_ADDRSTRLEN);
         client_port = ntohs(client_addr.sin_port);
-        printf("[Thread %lu] Client connected: %s:%d\n", (unsigned long)pthread_self(), client_ip, client_port);
+        log_printf(LOG_INFO, "[Thread %lu] Client connected: %s:%d\n", (unsigned long)pthread_self(), client_ip, client_port);
     } else {
         strcpy(client_ip, "unknown");
         client_port = 0;
-        printf("[Thread %lu] Client connected: address unknown\n", (unsigned long)pthread_self());
+        log_printf(LOG_INFO, "[Thread %lu] Client connected: address unknown\n", (unsigned long)pthread_self());
     }
     
+    // Responses are coalesced before sending, so Nagle's algorithm only adds delay
+    int nodelay = 1;
+    setsockopt(client_socket, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+    
     // Step 4: Send welcome message to client
        /* 
          🕵️HINT:
@@ -186,9 +1296,7 @@ void* handle_client_connection(void* socket_ptr) {
           client_ip, client_port);           
        */ 
     char welcome_msg[256];
-    snprintf(welcome_msg, sizeof(welcome_msg), 
-             "[SERVER] Hello %s:%d! Type 'HELP' for commands.\n" RESPONSE_END_MARKER "\n",
-             client_ip, client_port);
+    snprintf(welcome_msg, sizeof(welcome_msg), WELCOME_FORMAT, client_ip, client_port);
     send(client_socket, welcome_msg, strlen(welcome_msg), 0);
     
     // Step 5: Main command processing loop
@@ -202,261 +1310,701 @@ void* handle_client_connection(void* socket_ptr) {
             Break on EXIT command
          }
      */
+    ClientPipeline pipeline;
+    pipeline_init(&pipeline);
+    ClientStats client_stats;
+    client_stats_open(&client_stats);
+    Reply to = {client_socket, 0, 0, &pipeline.write_lock, &client_stats, 0, 0, 0};
+    RequestBuffer in;
+    in.len = 0;
+    in.eof = 0;
+    in.discarding = 0;
     while (1) {
-        memset(buffer, 0, BUFFER_SIZE);
-        ssize_t bytes_received = recv(client_socket, buffer, BUFFER_SIZE - 1, 0);
-        
-        if (bytes_received <= 0) {
-            if (bytes_received == 0) {
-                printf("[Thread %lu] Client %s:%d disconnected gracefully\n", 
+        // Take the next complete command, receiving more input as needed
+        int parsed = request_take(&in, &to, buffer);
+        if (parsed < 0 && !to.framed) {
+            reply_malformed(&to);
+            log_printf(LOG_WARN, "[Thread %lu] Client %s:%d sent an overlong line\n", 
                        (unsigned long)pthread_self(), client_ip, client_port);
-            } else {
-                printf("[Thread %lu] Client %s:%d disconnected with error\n", 
+            continue;
+        }
+        if (parsed < 0) {
+            pipeline_wait_idle(&pipeline);
+            reply_malformed(&to);
+            log_printf(LOG_WARN, "[Thread %lu] Client %s:%d sent a malformed request\n", 
                        (unsigned long)pthread_self(), client_ip, client_port);
-            }
             break;
         }
+        if (parsed == 0) {
+            if (in.eof) {
+                log_printf(LOG_INFO, "[Thread %lu] Client %s:%d disconnected gracefully\n", 
+                           (unsigned long)pthread_self(), client_ip, client_port);
+                break;
+            }
+            ssize_t bytes_received = recv(client_socket, in.data + in.len, sizeof(in.data) - in.len, 0);
+            if (bytes_received == 0) {
+                in.eof = 1;
+            } else if (bytes_received < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                log_printf(LOG_WARN, "[Thread %lu] Client %s:%d disconnected with error\n", 
+                           (unsigned long)pthread_self(), client_ip, client_port);
+                break;
+            } else {
+                in.len += (size_t)bytes_received;
+            }
+            continue;
+        }
         
-        buffer[bytes_received] = '\0';
-        
-        // Remove trailing newline and carriage return
-        char* newline = strchr(buffer, '\n');
-        if (newline) *newline = '\0';
-        char* carriage = strchr(buffer, '\r');
-        if (carriage) *carriage = '\0';
+        to.received_ns = now_ns();
         
-        // Skip empty commands
-        if (strlen(buffer) == 0) {
+        // Skip empty commands; a framed request is still answered, by id
+        if (buffer[0] == '\0') {
+            if (to.framed) {
+                reply_end(&to, NULL, 0, FRAME_STATUS_OK, 0, NULL, 0);
+            }
             continue;
         }
         
-        printf("[Thread %lu] Command from %s:%d: '%s'\n", 
-               (unsigned long)pthread_self(), client_ip, client_port, buffer);
+        log_printf(LOG_INFO, "[Thread %lu] Command from %s:%d: '%s'\n", 
+                   (unsigned long)pthread_self(), client_ip, client_port, buffer);
         
-        // Handle commands
-        if (strcmp(buffer, "EXIT") == 0 || strcmp(buffer, "HELP") == 0) {
-            handle_user_command(buffer, client_socket);
-            if (strcmp(buffer, "EXIT") == 0) {
-                break;
-            }
-        } else {
-            execute_shell_command(buffer, client_socket);
+        // Framed requests run concurrently on the command workers; EXIT
+        // waits for them so the goodbye is the last response
+        int is_exit = strcmp(buffer, "EXIT") == 0;
+        if (to.framed && pipeline_depth > 1 && !is_exit && pipeline_submit(&pipeline, &to, buffer) == 0) {
+            continue;
+        }
+        if (is_exit) {
+            pipeline_wait_idle(&pipeline);
+        }
+        
+        // Handle commands (EXIT, HELP, protocol switch or shell command)
+        if (handle_request(buffer, &to)) {
+            break;
         }
     }
     
+    // Commands still running write to the socket until they answer
+    pipeline_wait_idle(&pipeline);
+    pipeline_destroy(&pipeline);
+    client_stats_close();
+    
     // Step 6: Cleanup and close socket
     close(client_socket);
-    printf("[Thread %lu] Connection closed\n", (unsigned long)pthread_self());
-    
+    log_printf(LOG_INFO, "[Thread %lu] Connection closed\n", (unsigned long)pthread_self());
+}
+
+/**
+ * Thread entry for --thread-per-client mode: takes ownership of the
+ * malloc'd socket descriptor, frees it and serves the connection.
+ */
+void* handle_client_connection(void* socket_ptr) {
+    int client_socket = *(int*)socket_ptr;
+    free(socket_ptr);
+    serve_client(client_socket);
     return NULL;
 }
 
+/**
+ * Milliseconds left until a CLOCK_MONOTONIC deadline, 0 once it passed
+ */
+static int ms_until(const struct timespec* deadline) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    long ms = (deadline->tv_sec - now.tv_sec) * 1000 + (deadline->tv_nsec - now.tv_nsec) / 1000000;
+    return ms > 0 ? (int)ms : 0;
+}
+
+/**
+ * Open a pidfd for the child: it polls readable once the child exits
+ * Returns -1 where pidfd_open is not available (Linux before 5.3).
+ */
+static int open_pidfd(pid_t child_pid) {
+#ifdef SYS_pidfd_open
+    return (int)syscall(SYS_pidfd_open, child_pid, 0);
+#else
+    (void)child_pid;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+/**
+ * Reap the child if it exits before the deadline (fallback without pidfd)
+ * Returns 1 once reaped, 0 if it is still running at the deadline. Output
+ * reaches EOF just before the child becomes waitable, or earlier if the
+ * command closed its output, so this checks again every millisecond.
+ */
+static int reap_before(pid_t child_pid, int* status, const struct timespec* deadline) {
+    const struct timespec step = {0, 1000000};
+    while (1) {
+        pid_t done = waitpid(child_pid, status, WNOHANG);
+        if (done == child_pid || (done < 0 && errno != EINTR)) {
+            return 1;
+        }
+        if (ms_until(deadline) == 0) {
+            return 0;
+        }
+        nanosleep(&step, NULL);
+    }
+}
+
+/**
+ * How commands are started (set from the command line in main):
+ *   SPAWN_POSIX - posix_spawn(), which glibc implements with a vfork-style
+ *                 clone: the child shares the server's memory until exec, so
+ *                 the cost does not grow with the server's address space
+ *   SPAWN_FORK  - fork() followed by exec, the original implementation
+ * With direct_exec set, a command without shell syntax is run without bash,
+ * as the program found on PATH: "echo hi" runs /bin/echo, not the builtin.
+ */
+#define SPAWN_POSIX 0
+#define SPAWN_FORK 1
+#define DIRECT_EXEC_MAX_ARGS 64
+
+// Characters that need bash: expansion, quoting, redirection, control flow
+#define SHELL_METACHARACTERS "|&;<>()$`\\\"'*?[]{}#~=%!\n"
+
+static int spawn_backend = SPAWN_POSIX;
+static int direct_exec = 0;
+extern char** environ;
+
+/**
+ * Split a command into argv if bash would do nothing more than that
+ * Returns the argument count, 0 if the command needs the shell.
+ */
+static int split_simple_command(char* words, char* argv[]) {
+    if (strpbrk(words, SHELL_METACHARACTERS) != NULL) {
+        return 0;
+    }
+    int argc = 0;
+    char* save = NULL;
+    for (char* word = strtok_r(words, " \t", &save); word != NULL; word = strtok_r(NULL, " \t", &save)) {
+        if (argc == DIRECT_EXEC_MAX_ARGS) {
+            return 0;
+        }
+        argv[argc++] = word;
+    }
+    argv[argc] = NULL;
+    return argc;
+}
+
+/**
+ * Start a command with stdout and stderr on output_fd
+ * Returns the child pid, or -1 with errno set. The child gets the default
+ * SIGPIPE disposition back, since the server ignores it.
+ */
+static pid_t spawn_command(const char* command, int output_fd) {
+    char* bash_argv[] = {"bash", "-c", (char*)command, NULL};
+
+    if (spawn_backend == SPAWN_FORK) {
+        pid_t child_pid = fork();
+        if (child_pid == 0) {
+            // Redirect stdout and stderr to the pipe (dup2 clears close-on-exec)
+            if (dup2(output_fd, STDOUT_FILENO) < 0 || dup2(output_fd, STDERR_FILENO) < 0) {
+                perror("dup2");
+                _exit(EXIT_FAILURE);
+            }
+            signal(SIGPIPE, SIG_DFL);
+            
+            // Execute command with execlp()
+            execlp("/bin/bash", "bash", "-c", command, NULL);
+            perror("execlp");
+            _exit(EXIT_FAILURE);
+        }
+        return child_pid;
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+    sigset_t default_signals;
+    pid_t child_pid = -1;
+    int err;
+
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, output_fd, STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, output_fd, STDERR_FILENO);
+    posix_spawnattr_init(&attr);
+    sigemptyset(&default_signals);
+    sigaddset(&default_signals, SIGPIPE);
+    posix_spawnattr_setsigdefault(&attr, &default_signals);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGDEF);
+
+    err = -1;
+    if (direct_exec) {
+        char words[BUFFER_SIZE];
+        char* argv[DIRECT_EXEC_MAX_ARGS + 1];
+        snprintf(words, sizeof(words), "%s", command);
+        if (split_simple_command(words, argv) > 0) {
+            err = posix_spawnp(&child_pid, argv[0], &actions, &attr, argv, environ);
+        }
+    }
+    // a name missing from PATH may still be a bash builtin (cd, export, ...);
+    // otherwise bash reports the error with its usual message
+    if (err != 0) {
+        err = posix_spawn(&child_pid, "/bin/bash", &actions, &attr, bash_argv, environ);
+    }
+
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&actions);
+    if (err != 0) {
+        errno = err;
+        return -1;
+    }
+    return child_pid;
+}
+
+/**
+ * RESULT CACHE (--cache-ttl MS, off by default)
+ *
+ * Read-only commands asked for again and again (date, pwd, cat
+ * /etc/hostname) can be answered from memory instead of starting a process.
+ * A command is cacheable if it has no shell syntax and its program is on
+ * the allow-list (CACHE_DEFAULT_ALLOW, or --cache-allow). Its output is
+ * kept for the TTL and sent again for the same command string. Only a
+ * command that exited 0 in time, with all of its output still in the
+ * response buffer, is stored; failures and timeouts always run again.
+ *
+ * Entries are spread by hash over CACHE_SHARDS tables with a lock each, so
+ * lookups of different commands rarely wait for one another. A shard holds
+ * at most CACHE_SHARD_BYTES of commands and output and evicts its least
+ * recently used entries to make room; expired entries are dropped when
+ * they are found. A hit holds a reference, so the output is sent outside
+ * the lock. Hits, misses, stores and evictions are reported by STATS.
+ */
+#define CACHE_SHARDS 16
+#define CACHE_SHARD_BUCKETS 64
+#define CACHE_SHARD_BYTES (256 * 1024)      // 4 MB over all shards
+#define CACHE_MAX_ALLOW 32
+#define CACHE_DEFAULT_ALLOW "date,pwd,hostname,uname,whoami,id,uptime,cat,ls"
+
+typedef struct CacheEntry {
+    struct CacheEntry* chain;           // next in the hash bucket
+    struct CacheEntry* newer;           // LRU list of the shard
+    struct CacheEntry* older;
+    uint64_t hash;
+    uint64_t expires_ns;
+    int refs;                           // senders using output; guarded by the shard lock
+    int removed;                        // no longer in the shard; the last sender frees it
+    size_t size;                        // bytes charged to the shard
+    size_t output_len;
+    char* output;                       // after command in the same allocation
+    char command[];
+} CacheEntry;
+
+typedef struct {
+    pthread_mutex_t lock;
+    CacheEntry* buckets[CACHE_SHARD_BUCKETS];
+    CacheEntry* newest;
+    CacheEntry* oldest;
+    size_t bytes;
+} CacheShard;
+
+static uint64_t cache_ttl_ns = 0;           // 0 = cache off
+static CacheShard cache_shards[CACHE_SHARDS];
+static char cache_allow_names[BUFFER_SIZE] = CACHE_DEFAULT_ALLOW;
+static const char* cache_allow[CACHE_MAX_ALLOW];
+static int cache_allow_count = 0;
+
+static uint64_t cache_hash(const char* command) {
+    uint64_t hash = 14695981039346656037ull;        // FNV-1a
+    for (const unsigned char* p = (const unsigned char*)command; *p != '\0'; p++) {
+        hash = (hash ^ *p) * 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * Enable the cache with the allow-list in cache_allow_names (comma separated)
+ * Returns 0, or -1 if the list is empty or too long.
+ */
+static int cache_init(uint64_t ttl_ms) {
+    char* save = NULL;
+    for (char* name = strtok_r(cache_allow_names, ",", &save); name != NULL; name = strtok_r(NULL, ",", &save)) {
+        if (cache_allow_count == CACHE_MAX_ALLOW) {
+            return -1;
+        }
+        cache_allow[cache_allow_count++] = name;
+    }
+    if (cache_allow_count == 0) {
+        return -1;
+    }
+    for (int i = 0; i < CACHE_SHARDS; i++) {
+        pthread_mutex_init(&cache_shards[i].lock, NULL);
+    }
+    cache_ttl_ns = ttl_ms * 1000000u;
+    return 0;
+}
+
+/**
+ * Whether the command may be answered from the cache: no shell syntax and
+ * an allow-listed program
+ */
+static int cache_allowed(const char* command) {
+    if (strpbrk(command, SHELL_METACHARACTERS) != NULL) {
+        return 0;
+    }
+    size_t name_len = strcspn(command, " \t");
+    for (int i = 0; i < cache_allow_count; i++) {
+        if (strlen(cache_allow[i]) == name_len && strncmp(command, cache_allow[i], name_len) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static CacheShard* cache_shard(uint64_t hash) {
+    return &cache_shards[hash % CACHE_SHARDS];
+}
+
+static CacheEntry** cache_bucket(CacheShard* shard, uint64_t hash) {
+    return &shard->buckets[(hash / CACHE_SHARDS) % CACHE_SHARD_BUCKETS];
+}
+
+static void cache_lru_unlink(CacheShard* shard, CacheEntry* e) {
+    if (e->newer != NULL) {
+        e->newer->older = e->older;
+    } else {
+        shard->newest = e->older;
+    }
+    if (e->older != NULL) {
+        e->older->newer = e->newer;
+    } else {
+        shard->oldest = e->newer;
+    }
+}
+
+static void cache_lru_push(CacheShard* shard, CacheEntry* e) {
+    e->newer = NULL;
+    e->older = shard->newest;
+    if (shard->newest != NULL) {
+        shard->newest->newer = e;
+    } else {
+        shard->oldest = e;
+    }
+    shard->newest = e;
+}
+
+/**
+ * Take an entry out of its shard; called with the shard lock held
+ */
+static void cache_remove(CacheShard* shard, CacheEntry* e) {
+    CacheEntry** link = cache_bucket(shard, e->hash);
+    while (*link != e) {
+        link = &(*link)->chain;
+    }
+    *link = e->chain;
+    cache_lru_unlink(shard, e);
+    shard->bytes -= e->size;
+    e->removed = 1;
+    if (e->refs == 0) {
+        free(e);
+    }
+}
+
+/**
+ * Look the command up; on a hit the entry is returned with a reference
+ * that cache_release drops
+ */
+static CacheEntry* cache_lookup(const char* command) {
+    uint64_t hash = cache_hash(command);
+    CacheShard* shard = cache_shard(hash);
+    uint64_t now = now_ns();
+
+    pthread_mutex_lock(&shard->lock);
+    CacheEntry* e = *cache_bucket(shard, hash);
+    while (e != NULL && (e->hash != hash || strcmp(e->command, command) != 0)) {
+        e = e->chain;
+    }
+    if (e != NULL && now >= e->expires_ns) {
+        cache_remove(shard, e);
+        e = NULL;
+    }
+    if (e != NULL) {
+        e->refs++;
+        cache_lru_unlink(shard, e);
+        cache_lru_push(shard, e);
+    }
+    pthread_mutex_unlock(&shard->lock);
+    return e;
+}
+
+static void cache_release(CacheEntry* e) {
+    CacheShard* shard = cache_shard(e->hash);
+    pthread_mutex_lock(&shard->lock);
+    int last = --e->refs == 0 && e->removed;
+    pthread_mutex_unlock(&shard->lock);
+    if (last) {
+        free(e);
+    }
+}
+
+/**
+ * Keep a command's output for the TTL, replacing an older entry for it and
+ * evicting the least recently used ones if the shard would be over budget
+ */
+static void cache_store(const char* command, const char* output, size_t output_len) {
+    size_t command_len = strlen(command);
+    size_t size = sizeof(CacheEntry) + command_len + 1 + output_len;
+    if (size > CACHE_SHARD_BYTES) {
+        return;
+    }
+    CacheEntry* e = malloc(size);
+    if (e == NULL) {
+        return;
+    }
+    memcpy(e->command, command, command_len + 1);
+    e->output = e->command + command_len + 1;
+    memcpy(e->output, output, output_len);
+    e->output_len = output_len;
+    e->size = size;
+    e->hash = cache_hash(command);
+    e->expires_ns = now_ns() + cache_ttl_ns;
+    e->refs = 0;
+    e->removed = 0;
+
+    CacheShard* shard = cache_shard(e->hash);
+    CacheEntry** bucket = cache_bucket(shard, e->hash);
+    pthread_mutex_lock(&shard->lock);
+    for (CacheEntry* old = *bucket; old != NULL; old = old->chain) {
+        if (old->hash == e->hash && strcmp(old->command, command) == 0) {
+            cache_remove(shard, old);
+            break;
+        }
+    }
+    while (shard->bytes + size > CACHE_SHARD_BYTES) {
+        cache_remove(shard, shard->oldest);
+        stats_add(&stats.cache_evictions, 1);
+    }
+    e->chain = *bucket;
+    *bucket = e;
+    cache_lru_push(shard, e);
+    shard->bytes += size;
+    pthread_mutex_unlock(&shard->lock);
+    stats_add(&stats.cache_stores, 1);
+}
+
 /**
  * TODO 3: EXECUTE SHELL COMMANDS WITH TIMEOUT
  * 
- * Implement the execute_shell_command function to:
- * 1. Fork a child process using fork()
- * 2. In child process:
- *    - Create unique temporary file for output (/tmp/shell_output_<PID>.txt)
- *      Use snprintf() to create filename: snprintf(temp_file, sizeof(temp_file), "/tmp/shell_output_%d.txt", getpid());
- *    - Open temporary file with proper permissions (O_WRONLY | O_CREAT | O_TRUNC, 0644)
- *    - Redirect stdout and stderr to the temporary file using dup2()
- *    - Execute the command using execlp("/bin/bash", "bash", "-c", command, NULL)
+ * The execute_shell_command function:
+ * 1. Creates a pipe for the command output (close-on-exec, so children
+ *    forked by other threads do not keep it open)
+ * 2. Starts the child with spawn_command(): posix_spawn() (default) or
+ *    fork(), with stdout and stderr on the write end of the pipe, running
+ *    bash -c command (or the command itself with --direct-exec)
  * 3. In parent process:
- *    - Wait for child process with COMMAND_TIMEOUT seconds using sleep(COMMAND_TIMEOUT)
- *    - Use waitpid() with WNOHANG to check if child completed
- *    - If timeout occurs, kill child process with SIGKILL and send timeout message
- *    - If completed, call send_command_output() to send results
- *    - Clean up zombie process with waitpid()
+ *    - Opens a pidfd for the child and streams the output to the client
+ *      until the child exits, for at most COMMAND_TIMEOUT seconds
+ *      (send_command_output waits on the pipe and the pidfd in one poll)
+ *    - If the child is still running at the deadline, kills it with
+ *      SIGKILL and sends the timeout message
+ *    - Otherwise reaps it and ends the response with RESPONSE_END_MARKER,
+ *      or on a framed connection with a FRAME_END frame holding the exit code
+ * 
+ * A fast command therefore returns as soon as it exits, and completion
+ * does not depend on the pipe: a background job that keeps the output
+ * open does not hold the response. Without pidfd support the child is
+ * reaped by polling waitpid() after the output reaches EOF.
+ * 
+ * Output is not buffered on disk: nothing is written under /tmp, so there
+ * is no temporary file to unlink or to clean up at shutdown. Output sent
+ * before a timeout stays sent and is followed by the timeout message.
  * 
  * REQUIRED VARIABLES:
  * - pid_t child_pid;
  * - int status;
- * - char temp_file[128];
- * 
- * 🕵️ HINTS:
- * - Use fork() to create child process
- * - Use snprintf() to create unique filename with getpid() *      
- * - In child: use open(), dup2() for output redirection to temp file
- * - If dup2() fails, close the temp file descriptor before exit 
-        if (dup2(fd, STDOUT_FILENO) < 0) { perror("dup2 stdout"); close(fd); exit(EXIT_FAILURE); }
- * - Use execlp() to execute bash with -c option
- * - In parent: use sleep(COMMAND_TIMEOUT) and waitpid() with WNOHANG
- * - Use kill(child_pid, SIGKILL) for timeout
- * - Send timeout message: "Command Timeout (exceeded 3 seconds)\n" + RESPONSE_END_MARKER + "\n"
- * - Call send_command_output() when command completes normally
+ * - int output_pipe[2];
  * 
  * EXAMPLE OUTPUT:
  * [Thread 140234567890124] Executing shell command: 'ls -la'
  * [Thread 140234567890124] Forked child process 12347 for command execution
  * [Thread 140234567890124] Command completed
  */
-void execute_shell_command(char* command, int client_socket) {
+static void run_shell_command(const char* command, const Reply* to) {
    
-    /* YOUR CODE HERE - Implement shell command execution with timeout */
-    
     // Step 1: Declare required variables
     pid_t child_pid;
-    int status;
-    char temp_file[128];
+    int status = 0;
+    int output_pipe[2];
+    Response response;
     
-    // Step 2: Print command being executed
-    printf("[Thread %lu] Executing shell command: '%s'\n", (unsigned long)pthread_self(), command);
+    // Answer repeated read-only commands from the result cache
+    int cacheable = cache_ttl_ns > 0 && cache_allowed(command);
+    if (cacheable) {
+        CacheEntry* cached = cache_lookup(command);
+        if (cached != NULL) {
+            stats_add(&stats.cache_hits, 1);
+            reply_end(to, cached->output, cached->output_len, FRAME_STATUS_OK, 0, NULL, 0);
+            cache_release(cached);
+            return;
+        }
+        stats_add(&stats.cache_misses, 1);
+    }
     
-    // Step 3: Fork child process
-    child_pid = fork();
+    // Step 2: Print command being executed
+    log_printf(LOG_DEBUG, "[Thread %lu] Executing shell command: '%s'\n", (unsigned long)pthread_self(), command);
     
-    // Step 4: Child process implementation
-       /*
-        🕵️HINT:
-          if (child_pid == 0) {
-            Create temp file name
-            Open temp file for writing
-            Redirect stdout and stderr using dup2()
-            Execute command with execlp()
-            Handle errors and exit
-          }
-    */
-    if (child_pid == 0) {
-        // Create temp file name
-        snprintf(temp_file, sizeof(temp_file), "/tmp/shell_output_%d.txt", getpid());
-        
-        // Open temp file for writing
-        int fd = open(temp_file, O_WRONLY | O_CREAT | O_TRUNC, 0644);
-        if (fd < 0) {
-            perror("open temp file");
-            exit(EXIT_FAILURE);
-        }
-        
-        // Redirect stdout and stderr using dup2()
-        if (dup2(fd, STDOUT_FILENO) < 0) {
-            perror("dup2 stdout");
-            close(fd);
-            exit(EXIT_FAILURE);
-        }
-        if (dup2(fd, STDERR_FILENO) < 0) {
-            perror("dup2 stderr");
-            close(fd);
-            exit(EXIT_FAILURE);
-        }
-        
-        close(fd);
-        
-        // Execute command with execlp()
-        execlp("/bin/bash", "bash", "-c", command, NULL);
-        perror("execlp");
-        exit(EXIT_FAILURE);
+    // Step 3: Create the output pipe and start the child process
+    if (pipe2(output_pipe, O_CLOEXEC) < 0) {
+        log_printf(LOG_ERROR, "pipe: %s\n", strerror(errno));
+        char error_msg[256];
+        int len = snprintf(error_msg, sizeof(error_msg), "Pipe failed: %s\n", strerror(errno));
+        stats_add(&stats.commands_failed, 1);
+        reply_end(to, NULL, 0, FRAME_STATUS_ERROR, 0, error_msg, (size_t)len);
+        return;
     }
+    uint64_t spawn_start = now_ns();
+    child_pid = spawn_command(command, output_pipe[1]);
+    hist_record(&stats.spawn, spawn_start);
+    uint64_t run_start = now_ns();
     
-    // Step 5: Parent process implementation
-    //   else if (child_pid > 0) {
-    //     // Print forked message
-    //     // Sleep for timeout period
-    //     // Check if child completed with waitpid()
-    //     // Handle timeout or normal completion
-    //   }
-    else if (child_pid > 0) {
+    // Step 4: Parent process implementation
+    if (child_pid > 0) {
         // Print forked message
-        printf("[Thread %lu] Forked child process %d for command execution\n", 
-               (unsigned long)pthread_self(), child_pid);
+        log_printf(LOG_DEBUG, "[Thread %lu] %s child process %d for command execution\n", 
+                   (unsigned long)pthread_self(), spawn_backend == SPAWN_FORK ? "Forked" : "Spawned", child_pid);
+        close(output_pipe[1]);
         
-        // Sleep for timeout period
-        sleep(COMMAND_TIMEOUT);
+        // Stream output until the command exits or the timeout passes; a
+        // send that waits on a slow client still kills it on time
+        struct timespec deadline;
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += COMMAND_TIMEOUT;
+        int pidfd = open_pidfd(child_pid);
+        response_init(&response, to);
+        response.to.command_pid = child_pid;
+        response.to.command_deadline_ns = (uint64_t)deadline.tv_sec * 1000000000u + (uint64_t)deadline.tv_nsec;
+        int exited = send_command_output(&response, output_pipe[0], pidfd, &deadline);
+        response.to.command_pid = 0;        // reaped below
+        close(output_pipe[0]);
+        if (pidfd >= 0) {
+            close(pidfd);
+            if (exited) {
+                waitpid(child_pid, &status, 0);
+            }
+        } else {
+            exited = reap_before(child_pid, &status, &deadline);
+        }
         
-        // Check if child completed with waitpid()
-        if (waitpid(child_pid, &status, WNOHANG) == 0) {
+        // Check if child completed before the deadline
+        if (!exited) {
             // Child still running - timeout occurred
-            printf("[Thread %lu] Command timed out, killing child process %d\n", 
-                   (unsigned long)pthread_self(), child_pid);
+            log_printf(LOG_WARN, "[Thread %lu] Command timed out, killing child process %d\n", 
+                       (unsigned long)pthread_self(), child_pid);
             kill(child_pid, SIGKILL);
             waitpid(child_pid, &status, 0); // Clean up zombie
             
-            // Send timeout message
-            char timeout_msg[256];
-            snprintf(timeout_msg, sizeof(timeout_msg), 
-                     "Command Timeout (exceeded %d seconds)\n" RESPONSE_END_MARKER "\n", 
-                     COMMAND_TIMEOUT);
-            send(client_socket, timeout_msg, strlen(timeout_msg), 0);
+            // Send the remaining output and the timeout message; the client
+            // gets a full write window for them, however late it is
+            response_end(&response, FRAME_STATUS_TIMEOUT, 0, TIMEOUT_TEXT, sizeof(TIMEOUT_TEXT) - 1);
+            stats_add(&stats.commands_timed_out, 1);
         } else {
-            // Command completed normally
-            printf("[Thread %lu] Command completed\n", (unsigned long)pthread_self());
-            send_command_output(client_socket, child_pid);
+            // Command completed normally: remaining output plus the end of
+            // the response (the exit code only travels in framed mode)
+            log_printf(LOG_DEBUG, "[Thread %lu] Command completed\n", (unsigned long)pthread_self());
+            int code = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+            if (cacheable && code == 0 && response.flushed == 0) {
+                cache_store(command, response.data, response.len);
+            }
+            response_end(&response, FRAME_STATUS_OK, code, NULL, 0);
         }
+        hist_record(&stats.run, run_start);
     }
     
-    // Step 6: Handle fork error
+    // Step 5: Handle fork / spawn error
     else {
-        perror("fork");
+        log_printf(LOG_ERROR, "spawn: %s\n", strerror(errno));
+        close(output_pipe[0]);
+        close(output_pipe[1]);
         char error_msg[256];
-        snprintf(error_msg, sizeof(error_msg), 
-                 "Fork failed: %s\n" RESPONSE_END_MARKER "\n", strerror(errno));
-        send(client_socket, error_msg, strlen(error_msg), 0);
+        int len = snprintf(error_msg, sizeof(error_msg), "Failed to start command: %s\n", strerror(errno));
+        stats_add(&stats.commands_failed, 1);
+        reply_end(to, NULL, 0, FRAME_STATUS_ERROR, 0, error_msg, (size_t)len);
     }
 }
 
+/**
+ * Run a shell command for a text protocol client
+ */
+void execute_shell_command(char* command, int client_socket) {
+    Reply to = {client_socket, 0, 0, NULL, NULL, now_ns(), 0, 0};
+    run_shell_command(command, &to);
+}
+
 /**
  * TODO 4: SEND COMMAND OUTPUT TO CLIENT
  * 
- * Implement the send_command_output function to:
- * 1. Create temporary filename using child PID
- * 2. Open the temporary file for reading
- * 3. Read the file contents line by line using fgets()
- * 4. Send each line to the client via TCP socket using send()
- * 5. Send end-of-response marker: RESPONSE_END_MARKER + "\n"
- * 6. Close file and delete temporary file with unlink()
- * 7. Handle file access errors gracefully
- * 
- * REQUIRED VARIABLES:
- * - char temp_file[128];
- * - char buffer[BUFFER_SIZE];
- * - FILE* file;
+ * The send_command_output function streams a running command's output:
+ * 1. Waits with poll() on the output pipe and the child's pidfd, never
+ *    past the deadline
+ * 2. Reads whatever output is available into the response buffer
+ * 3. Flushes the buffer when it is full, or when no more output arrives
+ *    within RESPONSE_FLUSH_DELAY_MS, so output still appears as it is
+ *    produced
+ * 4. When the pidfd fires, reads what is still buffered in the pipe
+ *    (anything a background job writes later is dropped) and returns 1
+ * 5. Returns 0 at the deadline, even while output keeps coming, or at EOF
+ *    when there is no pidfd (-1)
  * 
- * 🕵️ HINTS:
- * - Use fopen() to open the same file (💡line 152 above) created earlier with uniquue child process PID for reading ("r" mode)
- *   --> file = fopen(temp_file, "r");
- * - Use fgets() to read line by line
- * - Use send() to transmit each line to client
- * - Send RESPONSE_END_MARKER + "\n" to indicate end of output
- * - Use unlink() to delete temporary file
- * - Handle file access errors by sending error message
+ * Output read last stays in the response: the caller sends it together
+ * with the end marker, or the timeout message, once it knows whether the
+ * command finished in time. If the client goes away, the rest of the
+ * output is read and discarded so the command is not blocked on a full
+ * pipe.
  */
-void send_command_output(int client_socket, pid_t child_pid) {
-
-    /* YOUR CODE HERE - Implement sending command output to client */
-    
-    // Step 1: Declare required variables
-    char temp_file[128];
-    char buffer[BUFFER_SIZE];
-    FILE* file;
-    
-    // Step 2: Create temporary filename
-    snprintf(temp_file, sizeof(temp_file), "/tmp/shell_output_%d.txt", child_pid);
-    
-    // Step 3: Open file for reading
-    file = fopen(temp_file, "r");
-    if (file == NULL) {
-        perror("fopen temp file for reading");
-        char error_msg[256];
-        snprintf(error_msg, sizeof(error_msg), 
-                 "Error reading command output: %s\n" RESPONSE_END_MARKER "\n", 
-                 strerror(errno));
-        send(client_socket, error_msg, strlen(error_msg), 0);
-        return;
-    }
+static int send_command_output(Response* response, int output_fd, int pidfd, const struct timespec* deadline) {
+    struct pollfd pfds[2] = {{output_fd, POLLIN, 0}, {pidfd, POLLIN, 0}};
     
-    // Step 4: Read and send file contents line by line
-    while (fgets(buffer, sizeof(buffer), file) != NULL) {
-        send(client_socket, buffer, strlen(buffer), 0);
+    while (1) {
+        if (pfds[0].fd < 0 && pidfd < 0) {
+            return 0;                       // EOF, the caller reaps the child
+        }
+        int timeout = ms_until(deadline);
+        if (response->len > 0 && timeout > RESPONSE_FLUSH_DELAY_MS) {
+            timeout = RESPONSE_FLUSH_DELAY_MS;
+        }
+        int ready = poll(pfds, pidfd >= 0 ? 2 : 1, timeout);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready < 0 || ms_until(deadline) == 0) {
+            return 0;
+        }
+        if (ready == 0) {
+            response_flush(response);       // the command went quiet
+            continue;
+        }
+        
+        if (pfds[0].revents) {
+            ssize_t n = response_read(response, output_fd, RESPONSE_BUFFER_SIZE);
+            if (n == 0 || (n < 0 && errno != EINTR)) {
+                pfds[0].fd = -1;            // EOF or error: stop polling the pipe
+            }
+        }
+        
+        if (pidfd >= 0 && (pfds[1].revents & POLLIN)) {
+            // take what the command wrote before exiting; a background job
+            // that keeps the pipe open may write more, which is dropped
+            int pending = 0;
+            if (pfds[0].fd >= 0 && ioctl(output_fd, FIONREAD, &pending) < 0) {
+                pending = 0;
+            }
+            while (pending > 0) {
+                ssize_t n = response_read(response, output_fd, (size_t)pending);
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (n <= 0) {
+                    break;
+                }
+                pending -= (int)n;
+            }
+            return 1;
+        }
     }
-    
-    // Step 5: Send end-of-response marker
-    char end_marker[64];
-    snprintf(end_marker, sizeof(end_marker), RESPONSE_END_MARKER "\n");
-    send(client_socket, end_marker, strlen(end_marker), 0);
-    
-    // Step 6: Close file and cleanup
-    fclose(file);
-    unlink(temp_file);
 }
 
 /**
@@ -466,7 +2014,8 @@ void send_command_output(int client_socket, pid_t child_pid) {
  * 1. Check if command is "EXIT" - send goodbye message and return
  * 2. Check if command is "HELP" - send comprehensive help information
  * 3. For any other command, call execute_shell_command() to treat as shell command
- * 4. All responses must include RESPONSE_END_MARKER + "\n"
+ * 4. All responses must include RESPONSE_END_MARKER + "\n" (reply_end adds
+ *    it, or ends the response with a FRAME_END frame on framed connections)
  * 
  * 🕵️ HINTS:
  * - Use strcmp() to compare command strings
@@ -480,62 +2029,72 @@ void send_command_output(int client_socket, pid_t child_pid) {
  * - Examples section
  * - Usage instructions
  */
-void handle_user_command(char* command, int client_socket) {
+static void run_user_command(const char* command, const Reply* to) {
     
     /* YOUR CODE HERE - Implement user command handling */
     
     // Step 1: Print debug message
-    printf("[Thread %lu] Handling user command: '%s'\n", (unsigned long)pthread_self(), command);
+    log_printf(LOG_DEBUG, "[Thread %lu] Handling user command: '%s'\n", (unsigned long)pthread_self(), command);
     
     // Step 2: Check for EXIT command
     if (strcmp(command, "EXIT") == 0) {
-        char goodbye_msg[128];
-        snprintf(goodbye_msg, sizeof(goodbye_msg), 
-                 "Goodbye! Connection closing...\n" RESPONSE_END_MARKER "\n");
-        send(client_socket, goodbye_msg, strlen(goodbye_msg), 0);
+        reply_end(to, GOODBYE_TEXT, sizeof(GOODBYE_TEXT) - 1, FRAME_STATUS_CLOSING, 0, NULL, 0);
         return;
     }
     
-    // Step 3: Check for HELP command and send the following multi-line help message 
-            /*  
-               🕵️HINT:
-                  Available Commands:
-                    Shell Commands:
-                    ls, pwd, date, echo, sleep, cat, etc. - Any valid shell command
-                    ./program - Execute custom programs
-                  Client Commands:
-                    HELP - Show available commands
-                    EXIT - Disconnect and quit client
-                  Examples:
-                    ls -la
-                    pwd
-                    sleep 5
-                    echo 'Hello World'
-                    cat /etc/hostname
-            */
+    // Step 3: Check for HELP command and send the precomputed help text (HELP_TEXT)
     if (strcmp(command, "HELP") == 0) {
-        char help_msg[1024];
-        snprintf(help_msg, sizeof(help_msg),
-                 "Available Commands:\n"
-                 "  Shell Commands:\n"
-                 "  ls, pwd, date, echo, sleep, cat, etc. - Any valid shell command\n"
-                 "  ./program - Execute custom programs\n"
-                 "Client Commands:\n"
-                 "  HELP - Show available commands\n"
-                 "  EXIT - Disconnect and quit client\n"
-                 "Examples:\n"
-                 "  ls -la\n"
-                 "  pwd\n"
-                 "  sleep 5\n"
-                 "  echo 'Hello World'\n"
-                 "  cat /etc/hostname\n"
-                 RESPONSE_END_MARKER "\n");
-        send(client_socket, help_msg, strlen(help_msg), 0);
+        reply_end(to, HELP_TEXT, sizeof(HELP_TEXT) - 1, FRAME_STATUS_OK, 0, NULL, 0);
+        return;
+    }
+    
+    // STATS reports the server metrics and this client's own counters
+    if (strcmp(command, "STATS") == 0) {
+        char text[STATS_TEXT_SIZE];
+        size_t len = format_stats(text, sizeof(text), to->client);
+        reply_end(to, text, len, FRAME_STATUS_OK, 0, NULL, 0);
         return;
     }
     
     // Step 4: Handle unknown commands as shell commands
-    execute_shell_command(command, client_socket);
+    run_shell_command(command, to);
+}
+
+/**
+ * Handle EXIT / HELP for a text protocol client
+ */
+void handle_user_command(char* command, int client_socket) {
+    Reply to = {client_socket, 0, 0, NULL, NULL, now_ns(), 0, 0};
+    run_user_command(command, &to);
+}
+
+/**
+ * Answer one request on a connection, in either protocol
+ * On a text connection PROTOCOL_FRAMED_REQUEST switches the connection to
+ * frames: the confirmation still goes out as text, then to->framed is set
+ * for the requests that follow. Returns 1 after EXIT, when the caller
+ * closes the connection, 0 otherwise.
+ */
+static int handle_request(const char* command, Reply* to) {
+    int close_after = 0;
+    hist_record(&stats.queue, to->received_ns);
+    stats_add(&stats.commands, 1);
+    if (to->client != NULL) {
+        stats_add(&to->client->commands, 1);
+    }
+
+    if (!to->framed && strcmp(command, PROTOCOL_FRAMED_REQUEST) == 0) {
+        log_printf(LOG_INFO, "[Thread %lu] Switching to framed protocol\n", (unsigned long)pthread_self());
+        reply_end(to, FRAMED_TEXT, sizeof(FRAMED_TEXT) - 1, FRAME_STATUS_OK, 0, NULL, 0);
+        to->framed = 1;
+    } else if (strcmp(command, "EXIT") == 0 || strcmp(command, "HELP") == 0 || strcmp(command, "STATS") == 0) {
+        run_user_command(command, to);
+        close_after = strcmp(command, "EXIT") == 0;
+    } else {
+        run_shell_command(command, to);
+    }
+    hist_record(&stats.total, to->received_ns);
+    return close_after;
 }
 
 /**
@@ -545,15 +2104,13 @@ void handle_user_command(char* command, int client_socket) {
  * 1. Print shutdown message with signal number
  * 2. Set server_running flag to 0
  * 3. Close the TCP server socket if valid
- * 4. Clean up any temporary files using system()
- * 5. Print cleanup completion messages
- * 6. Exit the program with exit(0)
+ * 4. Print cleanup completion messages
+ * 5. Exit the program with exit(0)
  * 
  * 🕵️ HINTS:
  * - This function is called when user presses Ctrl+C (SIGINT)
  * - Print: "[Main Thread] Received signal %d, shutting down gracefully...\n"
  * - Check if tcp_server_socket >= 0 before closing
- * - Use system("rm -f /tmp/shell_output_*.txt") to remove temporary files
  * - Print progress messages for each cleanup step
  * - Use exit(0) to terminate program
  */
@@ -561,41 +2118,495 @@ void cleanup_and_exit(int sig) {
 
     /* YOUR CODE HERE - Implement cleanup and exit */
     
-    // Step 1: Print shutdown message
-    printf("\n[Main Thread] Received signal %d, shutting down gracefully...\n", sig);
+    // Step 1: Print shutdown message, after what is still buffered
+    log_flush();
+    log_printf(LOG_INFO, "\n[Main Thread] Received signal %d, shutting down gracefully...\n", sig);
     
     // Step 2: Set server_running to 0
     server_running = 0;
     
     // Step 3: Close server socket if valid
     if (tcp_server_socket >= 0) {
-        printf("[Main Thread] Closing server socket...\n");
+        log_printf(LOG_INFO, "[Main Thread] Closing server socket...\n");
         close(tcp_server_socket);
         tcp_server_socket = -1;
     }
     
-    // Step 4: Clean up temporary files
-    printf("[Main Thread] Cleaning up temporary files...\n");
-    system("rm -f /tmp/shell_output_*.txt");
-    
-    // Step 5: Print completion message and exit
-    printf("[Main Thread] Server shutdown complete\n");
+    // Step 4: Print completion message and exit (command output goes
+    // through pipes, so there are no temporary files to remove)
+    log_printf(LOG_INFO, "[Main Thread] Server shutdown complete\n");
     exit(0);
 }
 
+/**
+ * CONNECTION WORKER POOL
+ *
+ * Instead of creating and detaching a thread for every accepted socket,
+ * main() hands client sockets to a fixed set of worker threads, sized from
+ * the number of online cores, through a queue; a worker serves each
+ * connection until it closes and then takes the next one, so short
+ * connections reuse threads instead of each costing a new one.
+ *
+ * A worker is busy for the whole life of a connection (it blocks in recv
+ * between commands), so the pool is oversubscribed relative to the cores,
+ * and a socket is only queued for a worker that is waiting for one. When
+ * every worker is busy the connection gets its own thread, as with
+ * --thread-per-client, so idle clients never keep a new one waiting.
+ */
+#define POOL_THREADS_PER_CORE 4
+#define POOL_MIN_WORKERS 8
+#define POOL_MAX_WORKERS 256
+#define CONN_QUEUE_CAPACITY MAX_CLIENTS
+
+typedef struct {
+    int fds[CONN_QUEUE_CAPACITY];   // ring of accepted client sockets
+    int head;                       // next socket to pop
+    int count;                      // sockets waiting
+    int idle;                       // workers waiting in conn_queue_pop
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+} ConnQueue;
+
+static ConnQueue conn_queue = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .not_empty = PTHREAD_COND_INITIALIZER,
+};
+
+/**
+ * Queue an accepted socket if a worker is free to take it
+ * Returns -1 if every worker is busy with a connection.
+ */
+static int conn_queue_offer(ConnQueue* q, int client_socket) {
+    pthread_mutex_lock(&q->lock);
+    if (q->count >= q->idle || q->count == CONN_QUEUE_CAPACITY) {
+        pthread_mutex_unlock(&q->lock);
+        return -1;
+    }
+    q->fds[(q->head + q->count) % CONN_QUEUE_CAPACITY] = client_socket;
+    q->count++;
+    pthread_cond_signal(&q->not_empty);
+    pthread_mutex_unlock(&q->lock);
+    return 0;
+}
+
+/**
+ * Remove the oldest socket, blocking while the queue is empty
+ */
+static int conn_queue_pop(ConnQueue* q) {
+    pthread_mutex_lock(&q->lock);
+    q->idle++;
+    while (q->count == 0) {
+        pthread_cond_wait(&q->not_empty, &q->lock);
+    }
+    q->idle--;
+    int client_socket = q->fds[q->head];
+    q->head = (q->head + 1) % CONN_QUEUE_CAPACITY;
+    q->count--;
+    pthread_mutex_unlock(&q->lock);
+    return client_socket;
+}
+
+static void* pool_worker(void* arg) {
+    (void)arg;
+    while (1) {
+        serve_client(conn_queue_pop(&conn_queue));
+    }
+    return NULL;
+}
+
+/**
+ * Default worker count: POOL_THREADS_PER_CORE per online core, clamped
+ */
+static int default_pool_size(void) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    long workers = (cores > 0 ? cores : 1) * POOL_THREADS_PER_CORE;
+    if (workers < POOL_MIN_WORKERS) {
+        workers = POOL_MIN_WORKERS;
+    }
+    if (workers > POOL_MAX_WORKERS) {
+        workers = POOL_MAX_WORKERS;
+    }
+    return (int)workers;
+}
+
+/**
+ * Start the detached worker threads
+ * Returns the number started; the caller falls back if it is 0
+ */
+static int start_worker_pool(int workers) {
+    int started = 0;
+    for (int i = 0; i < workers; i++) {
+        pthread_t worker;
+        if (pthread_create(&worker, NULL, pool_worker, NULL) != 0) {
+            perror("Failed to create worker thread");
+            break;
+        }
+        pthread_detach(worker);
+        started++;
+    }
+    log_printf(LOG_INFO, "[Main Thread] Started %d worker threads\n", started);
+    return started;
+}
+
+/**
+ * EVENT LOOP MODE (--epoll)
+ *
+ * One thread waits in epoll on the listening socket and every client
+ * socket, so an idle client costs an EventConn and no thread. Client
+ * sockets are non-blocking and registered with EPOLLONESHOT: an event
+ * disarms the socket until the loop re-arms it.
+ *
+ * The loop does all reading and parsing. Received bytes are appended to
+ * the connection's request buffer and each complete line (or request frame,
+ * once the client switched to the framed protocol) becomes a CommandJob for
+ * the command workers, which send the response and hand the job back
+ * through done_list and the eventfd. A text connection has one job running
+ * at a time; a framed one up to pipeline_depth (see PIPELINED REQUESTS).
+ *
+ * The socket is re-armed only when no complete request is waiting in the
+ * buffer, so a client over its limit is not read until a command finishes.
+ * After EXIT, or once the client has closed and no requests are left, the
+ * loop closes the connection as soon as its last command has answered.
+ */
+#define EVENT_BATCH 64
+
+typedef struct EventConn {
+    int fd;
+    int framed;                     // framed protocol, set once the switch has answered
+    int inflight;                   // jobs handed to the workers and not yet taken back
+    int closing;                    // no more requests: close once inflight is 0
+    const char* close_reason;       // logged on close, NULL after EXIT
+    CommandJob* held;               // EXIT or malformed frame waiting for inflight to drain
+    char client_ip[INET_ADDRSTRLEN];
+    int client_port;
+    RequestBuffer in;               // received, not yet parsed; in.eof: finish buffered lines, then close
+    pthread_mutex_t write_lock;     // workers answering the same client take turns
+    ClientStats stats;
+} EventConn;
+
+static JobList done_list = {NULL, NULL, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER};
+static int loop_epoll_fd = -1;
+static int loop_wake_fd = -1;       // eventfd, written after every push to done_list
+
+static void set_nonblocking(int fd, int on) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags >= 0) {
+        fcntl(fd, F_SETFL, on ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK));
+    }
+}
+
+/**
+ * Worker side: give the answered job back to the loop
+ */
+static void loop_job_done(CommandJob* job) {
+    job_list_push(&done_list, job);
+    uint64_t one = 1;
+    if (write(loop_wake_fd, &one, sizeof(one)) < 0) {
+        log_printf(LOG_ERROR, "eventfd write: %s\n", strerror(errno));
+    }
+}
+
+//------------------------------------------------------------------//
+
+static void loop_close(EventConn* c) {
+    if (c->close_reason != NULL) {
+        log_printf(LOG_INFO, "[Thread %lu] Client %s:%d %s\n", (unsigned long)pthread_self(), c->client_ip,
+                   c->client_port, c->close_reason);
+    }
+    epoll_ctl(loop_epoll_fd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    log_printf(LOG_INFO, "[Thread %lu] Connection closed\n", (unsigned long)pthread_self());
+    client_stats_close();
+    pthread_mutex_destroy(&c->write_lock);
+    free(c->held);
+    free(c);
+}
+
+/**
+ * Stop taking requests; the connection closes once its commands answered
+ */
+static void loop_finish(EventConn* c, const char* reason) {
+    c->closing = 1;
+    c->close_reason = reason;
+    if (c->inflight == 0) {
+        loop_close(c);
+    }
+}
+
+static void loop_arm(EventConn* c) {
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLONESHOT;
+    ev.data.ptr = c;
+    if (epoll_ctl(loop_epoll_fd, EPOLL_CTL_MOD, c->fd, &ev) < 0) {
+        log_printf(LOG_ERROR, "epoll_ctl rearm: %s\n", strerror(errno));
+        loop_finish(c, "dropped");
+    }
+}
+
+/**
+ * Parse the next buffered request into a new job
+ * Returns NULL if no complete request is buffered (or out of memory,
+ * with *need_input left 0).
+ */
+static CommandJob* loop_next_job(EventConn* c, int* need_input) {
+    while (1) {
+        CommandJob* job = malloc(sizeof(CommandJob));
+        if (job == NULL) {
+            log_printf(LOG_ERROR, "Memory allocation failed for command: %s\n", strerror(errno));
+            return NULL;
+        }
+        job->to = (Reply){c->fd, c->framed, 0, &c->write_lock, &c->stats, now_ns(), 0, 0};
+        int parsed = request_take(&c->in, &job->to, job->command);
+        if (parsed == 0) {
+            free(job);
+            *need_input = 1;
+            return NULL;
+        }
+        job->malformed = parsed < 0;
+        job->done = loop_job_done;
+        job->owner = c;
+        if (!job->malformed && job->command[0] == '\0' && !c->framed) {
+            free(job);                  // an empty frame is still answered, by id
+            continue;
+        }
+        if (job->malformed && !c->framed) {
+            log_printf(LOG_WARN, "[Thread %lu] Client %s:%d sent an overlong line\n",
+                       (unsigned long)pthread_self(), c->client_ip, c->client_port);
+        } else if (!job->malformed && job->command[0] != '\0') {
+            log_printf(LOG_INFO, "[Thread %lu] Command from %s:%d: '%s'\n",
+                       (unsigned long)pthread_self(), c->client_ip, c->client_port, job->command);
+        }
+        return job;
+    }
+}
+
+/**
+ * Hand buffered requests to the workers, as many as the connection may run
+ * at once, then re-arm for more input or close the connection
+ */
+static void loop_dispatch(EventConn* c) {
+    int need_input = 0;
+    while (!c->closing && c->inflight < (c->framed ? pipeline_depth : 1)) {
+        CommandJob* job = c->held;
+        c->held = NULL;
+        if (job == NULL && (job = loop_next_job(c, &need_input)) == NULL) {
+            break;
+        }
+
+        // EXIT and a malformed frame end the connection: they wait until
+        // the running commands have answered, and nothing is read after them.
+        // An overlong text line is only answered with an error.
+        int last = (job->malformed && job->to.framed) || (!job->malformed && strcmp(job->command, "EXIT") == 0);
+        if (last && c->inflight > 0) {
+            c->held = job;
+            return;
+        }
+        if (last) {
+            c->closing = 1;
+            c->close_reason = job->malformed ? "sent a malformed request" : NULL;
+        }
+        c->inflight++;
+        job_list_push(&job_list, job);
+    }
+
+    if (c->closing || (need_input && c->in.eof)) {
+        if (!c->closing) {
+            loop_finish(c, "disconnected gracefully");
+        } else if (c->inflight == 0) {
+            loop_close(c);
+        }
+    } else if (need_input) {
+        loop_arm(c);
+    } else if (c->inflight == 0) {
+        loop_finish(c, "dropped");      // out of memory with nothing running
+    }
+}
+
+/**
+ * Drain the socket into the read buffer
+ * Returns -1 if the connection was closed on an error
+ */
+static int loop_read(EventConn* c) {
+    while (c->in.len < sizeof(c->in.data)) {
+        ssize_t n = recv(c->fd, c->in.data + c->in.len, sizeof(c->in.data) - c->in.len, 0);
+        if (n > 0) {
+            c->in.len += (size_t)n;
+        } else if (n == 0) {
+            c->in.eof = 1;
+            break;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else if (errno != EINTR) {
+            loop_finish(c, "disconnected with error");
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static void loop_accept(int listen_fd) {
+    while (1) {
+        struct sockaddr_in client_addr;
+        socklen_t addr_len = sizeof(client_addr);
+        int fd = accept4(listen_fd, (struct sockaddr*)&client_addr, &addr_len, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                log_printf(LOG_ERROR, "Accept failed: %s\n", strerror(errno));
+            }
+            return;
+        }
+
+        EventConn* c = calloc(1, sizeof(EventConn));
+        if (c == NULL) {
+            log_printf(LOG_ERROR, "Memory allocation failed for connection: %s\n", strerror(errno));
+            close(fd);
+            continue;
+        }
+        c->fd = fd;
+        pthread_mutex_init(&c->write_lock, NULL);
+        client_stats_open(&c->stats);
+        inet_ntop(AF_INET, &client_addr.sin_addr, c->client_ip, INET_ADDRSTRLEN);
+        c->client_port = ntohs(client_addr.sin_port);
+        log_printf(LOG_INFO, "[Thread %lu] Client connected: %s:%d\n", (unsigned long)pthread_self(), c->client_ip, c->client_port);
+        set_nonblocking(fd, 1);
+        int nodelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+        // a fresh socket's send buffer is empty, so the welcome goes out whole
+        char welcome_msg[256];
+        int len = snprintf(welcome_msg, sizeof(welcome_msg), WELCOME_FORMAT, c->client_ip, c->client_port);
+        struct epoll_event ev;
+        ev.events = EPOLLIN | EPOLLONESHOT;
+        ev.data.ptr = c;
+        if (send(fd, welcome_msg, (size_t)len, 0) != len || epoll_ctl(loop_epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            close(fd);
+            log_printf(LOG_INFO, "[Thread %lu] Connection closed\n", (unsigned long)pthread_self());
+            client_stats_close();
+            pthread_mutex_destroy(&c->write_lock);
+            free(c);
+        }
+    }
+}
+
+/**
+ * Take back answered jobs and give their connections the next requests
+ */
+static void loop_completed(void) {
+    uint64_t count;
+    if (read(loop_wake_fd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+        log_printf(LOG_ERROR, "eventfd read: %s\n", strerror(errno));
+    }
+    CommandJob* job = job_list_take_all(&done_list);
+    while (job != NULL) {
+        CommandJob* next = job->next;
+        EventConn* c = (EventConn*)job->owner;
+        c->framed = job->to.framed;     // set if the job was the protocol switch
+        c->inflight--;
+        free(job);
+        loop_dispatch(c);
+        job = next;
+    }
+}
+
+/**
+ * Serve every client from this thread until the server stops
+ * Returns -1 if the event loop could not be set up.
+ */
+static int run_event_loop(int listen_fd) {
+    // thousands of idle clients need more descriptors and a deeper backlog
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+    listen(listen_fd, SOMAXCONN);
+    set_nonblocking(listen_fd, 1);
+
+    loop_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    loop_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (loop_epoll_fd < 0 || loop_wake_fd < 0) {
+        perror("epoll setup");
+        return -1;
+    }
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;                 // NULL marks the listening socket
+    epoll_ctl(loop_epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev);
+    ev.data.ptr = &loop_wake_fd;
+    epoll_ctl(loop_epoll_fd, EPOLL_CTL_ADD, loop_wake_fd, &ev);
+
+    pthread_once(&command_workers_once, start_command_workers);
+    if (command_workers_started == 0) {
+        fprintf(stderr, "Failed to create command workers\n");
+        return -1;
+    }
+    log_printf(LOG_INFO, "[Main Thread] Event loop started\n");
+
+    struct epoll_event events[EVENT_BATCH];
+    while (server_running) {
+        int n = epoll_wait(loop_epoll_fd, events, EVENT_BATCH, -1);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            log_printf(LOG_ERROR, "epoll_wait: %s\n", strerror(errno));
+            return -1;
+        }
+        for (int i = 0; i < n; i++) {
+            void* tag = events[i].data.ptr;
+            if (tag == NULL) {
+                loop_accept(listen_fd);
+            } else if (tag == &loop_wake_fd) {
+                loop_completed();
+            } else {
+                EventConn* c = (EventConn*)tag;
+                if (loop_read(c) == 0) {
+                    loop_dispatch(c);
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * Print command line usage
+ */
+static void print_usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [--workers N] [--thread-per-client | --epoll] [--spawn posix|fork] [--direct-exec]"
+                    " [--pipeline N]\n"
+                    "       [--stats-interval S] [--log-level error|warn|info|debug]"
+                    " [--cache-ttl MS [--cache-allow P1,P2,...]]\n", prog);
+    fprintf(stderr, "  --workers N          worker pool and command worker count (default %d per core, at least %d)\n",
+            POOL_THREADS_PER_CORE, POOL_MIN_WORKERS);
+    fprintf(stderr, "  --thread-per-client  create a thread for every connection instead of the pool\n");
+    fprintf(stderr, "  --epoll              serve all clients from one event loop, commands run on the workers\n");
+    fprintf(stderr, "  --spawn posix|fork   start commands with posix_spawn (default) or fork + exec\n");
+    fprintf(stderr, "  --direct-exec        run commands without shell syntax directly, without bash\n");
+    fprintf(stderr, "  --pipeline N         commands one framed client may run at once (default %d, at most %d)\n",
+            PIPELINE_DEFAULT_DEPTH, PIPELINE_MAX_DEPTH);
+    fprintf(stderr, "  --stats-interval S   write the STATS metrics to the log every S seconds\n");
+    fprintf(stderr, "  --cache-ttl MS       answer repeated read-only commands from a cache for MS milliseconds\n");
+    fprintf(stderr, "  --cache-allow LIST   programs the cache may answer for (default %s)\n", CACHE_DEFAULT_ALLOW);
+    fprintf(stderr, "  --log-level L        least severe messages logged (default info; debug adds per-command detail)\n");
+}
+
 
-/* ################################### DO NOT MODIFY MAIN() FUNCTION ####################################### */
+/* ############################################ MAIN() FUNCTION ############################################ */
 
 
 /**
  * Print welcome banner
  */
 void print_welcome_banner() {
-    printf("=================================================================\n");
-    printf("        Socket-Based Multi-Client Shell Server Starting         \n");
-    printf("=================================================================\n");
-    printf("Server PID: %d\n", getpid());
-    printf("Main Thread ID: %lu\n",  (unsigned long)pthread_self());
+    log_printf(LOG_INFO, "=================================================================\n");
+    log_printf(LOG_INFO, "        Socket-Based Multi-Client Shell Server Starting         \n");
+    log_printf(LOG_INFO, "=================================================================\n");
+    log_printf(LOG_INFO, "Server PID: %d\n", getpid());
+    log_printf(LOG_INFO, "Main Thread ID: %lu\n",  (unsigned long)pthread_self());
 }
 
 
@@ -605,24 +2616,75 @@ void print_welcome_banner() {
  * Main() function is already implemented. It:
  * 1. Sets up signal handlers
  * 2. Creates TCP server socket  
- * 3. Accepts client connections in a loop
- * 4. Creates new thread for each client
- * 
- * You should not need to modify this function.
+ * 3. Runs the event loop instead of the steps below if --epoll is given
+ * 4. Starts the worker pool (unless --thread-per-client is given)
+ * 5. Accepts client connections in a loop
+ * 6. Queues each client for a free pool worker, or creates a new thread for it
  */
-int main() {
+int main(int argc, char* argv[]) {
     pthread_t client_thread;
+    int workers = default_pool_size();
+    int thread_per_client = 0;
+    int event_loop = 0;
+    int cache_ttl_ms = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            workers = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--thread-per-client") == 0) {
+            thread_per_client = 1;
+        } else if (strcmp(argv[i], "--epoll") == 0) {
+            event_loop = 1;
+        } else if (strcmp(argv[i], "--spawn") == 0 && i + 1 < argc
+                   && (strcmp(argv[i + 1], "posix") == 0 || strcmp(argv[i + 1], "fork") == 0)) {
+            spawn_backend = strcmp(argv[++i], "fork") == 0 ? SPAWN_FORK : SPAWN_POSIX;
+        } else if (strcmp(argv[i], "--direct-exec") == 0) {
+            direct_exec = 1;
+        } else if (strcmp(argv[i], "--pipeline") == 0 && i + 1 < argc
+                   && atoi(argv[i + 1]) > 0 && atoi(argv[i + 1]) <= PIPELINE_MAX_DEPTH) {
+            pipeline_depth = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--stats-interval") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            stats_interval = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--cache-ttl") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            cache_ttl_ms = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--cache-allow") == 0 && i + 1 < argc
+                   && strlen(argv[i + 1]) < sizeof(cache_allow_names)) {
+            snprintf(cache_allow_names, sizeof(cache_allow_names), "%s", argv[++i]);
+        } else if (strcmp(argv[i], "--log-level") == 0 && i + 1 < argc && log_level_from_name(argv[i + 1]) >= 0) {
+            log_level = log_level_from_name(argv[++i]);
+        } else {
+            print_usage(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    command_workers = workers;
+    if (cache_ttl_ms > 0 && cache_init((uint64_t)cache_ttl_ms) < 0) {
+        fprintf(stderr, "--cache-allow needs 1 to %d program names\n", CACHE_MAX_ALLOW);
+        exit(EXIT_FAILURE);
+    }
+    log_start();
     
-    printf("=================================================================\n");
-    printf("        Socket-Based Multi-Client Shell Server Starting         \n");
-    printf("=================================================================\n");
-    printf("Server PID: %d\n", getpid());
-    printf("Main Thread ID: %lu\n", (unsigned long)pthread_self());
+    log_printf(LOG_INFO, "=================================================================\n");
+    log_printf(LOG_INFO, "        Socket-Based Multi-Client Shell Server Starting         \n");
+    log_printf(LOG_INFO, "=================================================================\n");
+    log_printf(LOG_INFO, "Server PID: %d\n", getpid());
+    log_printf(LOG_INFO, "Main Thread ID: %lu\n", (unsigned long)pthread_self());
     
     // Setup signal handler for graceful shutdown
     signal(SIGINT, cleanup_and_exit);
     signal(SIGPIPE, SIG_IGN);  // Ignore broken pipe signals
 
+    // Metrics are always collected; the periodic dump is optional
+    stats.start_ns = now_ns();
+    if (stats_interval > 0) {
+        pthread_t dumper;
+        if (pthread_create(&dumper, NULL, stats_dumper, NULL) == 0) {
+            pthread_detach(dumper);
+        } else {
+            perror("Failed to create stats thread");
+        }
+    }
+
     // Setup TCP server socket
     tcp_server_socket = setup_tcp_server(SERVER_PORT);
     if (tcp_server_socket < 0) {
@@ -630,8 +2692,22 @@ int main() {
         exit(EXIT_FAILURE);
     }
 
-    printf("[Server] Waiting for client connections...\n");
-    printf("[Server] Press Ctrl+C to shutdown gracefully\n\n");
+    if (event_loop) {
+        log_printf(LOG_INFO, "[Server] Waiting for client connections...\n");
+        log_printf(LOG_INFO, "[Server] Press Ctrl+C to shutdown gracefully\n\n");
+        if (run_event_loop(tcp_server_socket) < 0) {
+            fprintf(stderr, "Event loop failed\n");
+        }
+        cleanup_and_exit(0);
+    }
+
+    if (!thread_per_client && start_worker_pool(workers) == 0) {
+        fprintf(stderr, "No worker threads, falling back to a thread per client\n");
+        thread_per_client = 1;
+    }
+
+    log_printf(LOG_INFO, "[Server] Waiting for client connections...\n");
+    log_printf(LOG_INFO, "[Server] Press Ctrl+C to shutdown gracefully\n\n");
 
     // Main server loop - accept and handle client connections
     while (server_running) {
@@ -639,26 +2715,31 @@ int main() {
         socklen_t client_addr_len = sizeof(client_addr);
         
         // Accept incoming client connection
-        int client_socket = accept(tcp_server_socket, 
-                                  (struct sockaddr*)&client_addr, 
-                                  &client_addr_len);
+        int client_socket = accept4(tcp_server_socket, 
+                                   (struct sockaddr*)&client_addr, 
+                                   &client_addr_len, SOCK_CLOEXEC);
         
         if (client_socket < 0) {
             if (server_running) {
-                perror("Accept failed");
+                log_printf(LOG_ERROR, "Accept failed: %s\n", strerror(errno));
             }
             continue;
         }
 
-        printf("[Main Thread %lu] Accepted connection from %s:%d\n",    
-               (unsigned long)pthread_self(),
-               inet_ntoa(client_addr.sin_addr), 
-               ntohs(client_addr.sin_port));
+        log_printf(LOG_INFO, "[Main Thread %lu] Accepted connection from %s:%d\n",    
+                   (unsigned long)pthread_self(),
+                   inet_ntoa(client_addr.sin_addr), 
+                   ntohs(client_addr.sin_port));
+
+        // A free pool worker takes the client; otherwise it gets a thread
+        if (!thread_per_client && conn_queue_offer(&conn_queue, client_socket) == 0) {
+            continue;
+        }
 
         // Allocate memory for passing socket to thread
         int* client_socket_ptr = malloc(sizeof(int));
         if (client_socket_ptr == NULL) {
-            perror("Memory allocation failed for client socket");
+            log_printf(LOG_ERROR, "Memory allocation failed for client socket: %s\n", strerror(errno));
             close(client_socket);
             continue;
         }
@@ -666,7 +2747,7 @@ int main() {
 
         // Create new thread to handle this client
         if (pthread_create(&client_thread, NULL, handle_client_connection, client_socket_ptr) != 0) {
-            perror("Failed to create client thread");
+            log_printf(LOG_ERROR, "Failed to create client thread: %s\n", strerror(errno));
             free(client_socket_ptr);
             close(client_socket);
             continue;
@@ -675,12 +2756,12 @@ int main() {
         // Detach thread for automatic cleanup
         pthread_detach(client_thread);
 
-        printf("[Main Thread %lu] Created thread %lu for client connection\n", 
-               (unsigned long)pthread_self(), (unsigned long)client_thread);
+        log_printf(LOG_INFO, "[Main Thread %lu] Created thread %lu for client connection\n", 
+                   (unsigned long)pthread_self(), (unsigned long)client_thread);
     }
 
-    printf("[Main Thread] Server main loop exiting\n");
+    log_printf(LOG_INFO, "[Main Thread] Server main loop exiting\n");
     cleanup_and_exit(0);
     
     return 0;
-}
\ No newline at end of file
+}